@@ -21,20 +21,23 @@
 #include "Applet.h"
 #include "Clock.h"
 #include "ThemeWidget.h"
-#include "Configuration.h"
+#include "ThemeIndex.h"
 
 #include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QElapsedTimer>
 #include <QtGui/QClipboard>
 #include <QtGui/QGraphicsLinearLayout>
 
 #include <KMenu>
+#include <KDebug>
 #include <KLocale>
+#include <KMessageBox>
 #include <KConfigDialog>
 #include <KStandardDirs>
 
-#include <Plasma/Package>
-
-K_EXPORT_PLASMA_APPLET(adjustableclock, AdjustableClock::Applet)
+#include <Plasma/Containment>
 
 namespace AdjustableClock
 {
@@ -43,7 +46,10 @@ Applet::Applet(QObject *parent, const QVariantList &args) : ClockApplet(parent,
     m_source(new DataSource(this)),
     m_clock(new Clock(m_source, false)),
     m_widget(new ThemeWidget(m_clock, this)),
-    m_clipboardAction(NULL)
+    m_clipboardAction(NULL),
+    m_configurationLibrary(NULL),
+    m_toolTipDependencies(0),
+    m_changedComponents(-1)
 {
     KGlobal::locale()->insertCatalog("libplasmaclock");
     KGlobal::locale()->insertCatalog("timezones4");
@@ -58,13 +64,47 @@ Applet::Applet(QObject *parent, const QVariantList &args) : ClockApplet(parent,
     setHasConfigurationInterface(true);
     setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
     resize(150, 100);
+
+    m_toolTipTimer.setSingleShot(true);
+
+    connect(&m_toolTipTimer, SIGNAL(timeout()), this, SLOT(updateToolTipContent()));
+    connect(m_clock, SIGNAL(componentChanged(ClockComponent)), this, SLOT(updateComponent(ClockComponent)));
+}
+
+Applet::~Applet()
+{
+    if (m_snapshotPath.isEmpty()) {
+        return;
+    }
+
+    QImage snapshot = (destroyed() ? QImage() : m_widget->getSnapshot());
+
+    if (snapshot.isNull()) {
+        QFile::remove(m_snapshotPath);
+    } else {
+        snapshot.setText("FormFactor", QString::number(formFactor()));
+        snapshot.setText("Geometry", QString("%1,%2,%3,%4").arg(geometry().x()).arg(geometry().y()).arg(geometry().width()).arg(geometry().height()));
+        snapshot.save(m_snapshotPath, "PNG");
+    }
 }
 
 void Applet::init()
 {
+    m_snapshotPath = KStandardDirs::locateLocal("cache", QString("adjustableclock/snapshot-%1-%2.png").arg(containment() ? containment()->id() : 0).arg(id()));
+
+    const QImage snapshot(m_snapshotPath);
+    const QStringList geometry = snapshot.text("Geometry").split(QLatin1Char(','));
+
+    if (geometry.count() == 4 && snapshot.text("FormFactor").toInt() == formFactor() && geometry.at(2).toDouble() > 0 && geometry.at(3).toDouble() > 0) {
+        resize(geometry.at(2).toDouble(), geometry.at(3).toDouble());
+    }
+
+    m_widget->setSnapshot(snapshot);
+
     ClockApplet::init();
 
     connect(this, SIGNAL(activate()), this, SLOT(copyToClipboard()));
+    connect(ThemeIndex::getInstance(), SIGNAL(themesChanged()), this, SLOT(updateTheme()));
 }
 
 void Applet::mousePressEvent(QGraphicsSceneMouseEvent *event)
@@ -78,35 +118,109 @@ void Applet::mousePressEvent(QGraphicsSceneMouseEvent *event)
 
 void Applet::createClockConfigurationInterface(KConfigDialog *parent)
 {
-    new Configuration(this, new Clock(m_source, true), parent);
+    if (!m_configurationLibrary) {
+        m_configurationLibrary = new KLibrary("plasma_applet_adjustableclock_config", KGlobal::mainComponent(), this);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    ConfigurationFactory factory = reinterpret_cast<ConfigurationFactory>(m_configurationLibrary->resolveFunction("adjustableclock_configuration"));
+
+    if (!factory) {
+        kWarning() << "Failed to load configuration module:" << m_configurationLibrary->errorString();
+
+        KMessageBox::error(parent, i18n("Failed to load configuration module:\n%1", m_configurationLibrary->errorString()));
+
+        return;
+    }
+
+    kDebug() << "Configuration module loaded in" << timer.elapsed() << "ms";
+
+    factory(this, new Clock(m_source, true), parent);
 }
 
 void Applet::clockConfigChanged()
 {
-    m_source->updateTimeZone();
+    m_changedComponents = -1;
+
+    m_clock->setTimeBudget(config().readEntry("evaluationTimeBudget", 250));
+    m_widget->setTickBudget(config().readEntry("tickTimeBudget", 100));
+
+    const QString timeZoneState = (QStringList(currentTimezone()) << config().readEntry("timeZones", QStringList()) << config().readEntry("holidaysRegions", QString())).join(QString(QChar('\n')));
+
+    if (timeZoneState != m_timeZoneState) {
+        m_timeZoneState = timeZoneState;
+
+        m_source->updateTimeZone();
+    }
 
-    if (!config().readEntry("themeHtml", QString()).isEmpty()) {
-        m_widget->setHtml(QString(), config().readEntry("themeHtml", QString()));
+    if (m_widget->isSnapshotPending()) {
+        connect(m_widget, SIGNAL(snapshotPresented()), this, SLOT(finishSnapshot()), Qt::UniqueConnection);
 
         return;
     }
 
+    updateTheme();
+
+    m_source->resetFeatures();
+}
+
+void Applet::finishSnapshot()
+{
+    disconnect(m_widget, SIGNAL(snapshotPresented()), this, SLOT(finishSnapshot()));
+
+    updateTheme();
+}
+
+void Applet::updateTheme()
+{
+    const QString html = config().readEntry("themeHtml", QString());
     const QString id = config().readEntry("theme", "digital");
-    const QStringList locations = KGlobal::dirs()->findDirs("data", "plasma/adjustableclock");
+    const QString key = (html.isEmpty() ? id : html);
+    const QMap<QString, QString> options = config().group("theme-" + id).entryMap();
 
-    for (int i = 0; i < locations.count(); ++i) {
-        const QStringList themes = Plasma::Package::listInstalled(locations.at(i));
+    if (key == m_themeKey && getThemeState(m_themePath) == m_themeState) {
+        if (options != m_themeOptions) {
+            m_themeOptions = options;
 
-        for (int j = 0; j < themes.count(); ++j) {
-            if (themes.at(j) == id && m_widget->setTheme(locations.at(i) + QDir::separator() + themes.at(j))) {
-                return;
-            }
+            m_widget->updateOptions();
         }
+
+        return;
+    }
+
+    m_themeKey = key;
+    m_themePath = QString();
+    m_themeOptions = options;
+
+    if (!html.isEmpty()) {
+        m_widget->setHtml(QString(), html);
+
+        m_themeState = QString();
+
+        m_source->resetFeatures();
+
+        return;
     }
 
-    if (!m_widget->setTheme(locations.first() + QDir::separator() + "digital")) {
+    const QStringList identifiers = (QStringList(id) << "digital");
+
+    for (int i = 0; (i < identifiers.count() && m_themePath.isEmpty()); ++i) {
+        const ThemeInfo theme = ThemeIndex::getInstance()->getTheme(identifiers.at(i));
+
+        if (!theme.path.isEmpty() && m_widget->setTheme(theme.path)) {
+            m_themePath = theme.path;
+        }
+    }
+
+    if (m_themePath.isEmpty()) {
         m_widget->setHtml(QString(), "<div style=\"text-align: center;\"><span component=\"Hour\">12</span>:<span component=\"Minute\">30</span></div>");
     }
+
+    m_themeState = getThemeState(m_themePath);
+
+    m_source->resetFeatures();
 }
 
 void Applet::clockConfigAccepted()
@@ -122,9 +236,29 @@ void Applet::changeEngineTimezone(const QString &oldTimeZone, const QString &new
     m_source->updateTimeZone();
 }
 
+QString Applet::getThemeState(const QString &path)
+{
+    if (path.isEmpty()) {
+        return QString();
+    }
+
+    QStringList state;
+    QDirIterator iterator(path, (QDir::Files | QDir::NoDotAndDotDot), QDirIterator::Subdirectories);
+
+    while (iterator.hasNext()) {
+        iterator.next();
+
+        state.append(QString("%1:%2:%3").arg(iterator.filePath()).arg(iterator.fileInfo().lastModified().toTime_t()).arg(iterator.fileInfo().size()));
+    }
+
+    state.sort();
+
+    return state.join(QString(QChar('\n')));
+}
+
 void Applet::copyToClipboard()
 {
-    QApplication::clipboard()->setText(m_clock->evaluate(config().readEntry("fastCopyExpression", "Clock.getValue(Clock.Year) + '-' + Clock.getValue(Clock.Month) + '-' + Clock.getValue(Clock.DayOfMonth) + ' ' + Clock.getValue(Clock.Hour) + ':' + Clock.getValue(Clock.Minute) + ':' + Clock.getValue(Clock.Second)")));
+    QApplication::clipboard()->setText(m_clock->evaluate(config().readEntry("fastCopyExpression", "%{Year}-%{Month}-%{DayOfMonth} %{Hour}:%{Minute}:%{Second}")));
 }
 
 void Applet::copyToClipboard(QAction *action)
@@ -135,13 +269,23 @@ void Applet::copyToClipboard(QAction *action)
 void Applet::toolTipAboutToShow()
 {
     if (config().keyList().contains("toolTipExpressionMain") || config().keyList().contains("toolTipExpressionSub")) {
-        if (config().readEntry("toolTipExpressionMain", QString()).isEmpty() && config().readEntry("toolTipExpressionSub", QString()).isEmpty()) {
+        m_toolTipMainExpression = config().readEntry("toolTipExpressionMain", QString());
+        m_toolTipSubExpression = config().readEntry("toolTipExpressionSub", QString());
+
+        if (m_toolTipMainExpression.isEmpty() && m_toolTipSubExpression.isEmpty()) {
             return;
         }
 
+        if (m_toolTipIcon.isNull()) {
+            m_toolTipIcon = KIcon("chronometer").pixmap(IconSize(KIconLoader::Desktop));
+        }
+
+        m_toolTipMainText = QString();
+        m_toolTipSubText = QString();
+
         updateToolTipContent();
 
-        connect(m_source, SIGNAL(tick()), this, SLOT(updateToolTipContent()));
+        connect(m_clock, SIGNAL(componentChanged(ClockComponent)), this, SLOT(updateToolTip(ClockComponent)), Qt::UniqueConnection);
     } else {
         ClockApplet::toolTipAboutToShow();
     }
@@ -149,53 +293,108 @@ void Applet::toolTipAboutToShow()
 
 void Applet::toolTipHidden()
 {
-    disconnect(m_source, SIGNAL(tick()), this, SLOT(updateToolTipContent()));
+    disconnect(m_clock, SIGNAL(componentChanged(ClockComponent)), this, SLOT(updateToolTip(ClockComponent)));
+
+    m_toolTipTimer.stop();
 
     Plasma::ToolTipManager::self()->clearContent(this);
 }
 
 void Applet::updateToolTipContent()
 {
+    int mainDependencies = 0;
+    int subDependencies = 0;
+    const QString mainText = m_clock->evaluate(m_toolTipMainExpression, &mainDependencies);
+    const QString subText = m_clock->evaluate(m_toolTipSubExpression, &subDependencies);
+
+    m_toolTipDependencies = (mainDependencies | subDependencies);
+
+    if (m_toolTipDependencies == 0 || (m_toolTipDependencies & (1 << MillisecondComponent))) {
+        m_toolTipDependencies |= (1 << SecondComponent);
+    }
+
+    if (mainText == m_toolTipMainText && subText == m_toolTipSubText) {
+        return;
+    }
+
+    m_toolTipMainText = mainText;
+    m_toolTipSubText = subText;
+
     Plasma::ToolTipContent toolTipData;
-    toolTipData.setImage(KIcon("chronometer").pixmap(IconSize(KIconLoader::Desktop)));
-    toolTipData.setMainText(m_clock->evaluate(config().readEntry("toolTipExpressionMain", QString())));
-    toolTipData.setSubText(m_clock->evaluate(config().readEntry("toolTipExpressionSub", QString())));
+    toolTipData.setImage(m_toolTipIcon);
+    toolTipData.setMainText(mainText);
+    toolTipData.setSubText(subText);
     toolTipData.setAutohide(false);
 
     Plasma::ToolTipManager::self()->setContent(this, toolTipData);
 }
 
+void Applet::updateToolTip(ClockComponent component)
+{
+    if (m_toolTipDependencies & (1 << component)) {
+        m_toolTipTimer.start(0);
+    }
+}
+
 void Applet::updateClipboardMenu()
 {
-    qDeleteAll(m_clipboardAction->menu()->actions());
+    const QStringList clipboardExpressions = getClipboardExpressions();
 
-    m_clipboardAction->menu()->clear();
+    if (clipboardExpressions != m_clipboardExpressions) {
+        qDeleteAll(m_clipboardAction->menu()->actions());
 
-    const QStringList clipboardExpressions = getClipboardExpressions();
+        m_clipboardAction->menu()->clear();
+
+        m_clipboardExpressions = clipboardExpressions;
+        m_clipboardDependencies.clear();
 
-    for (int i = 0; i < clipboardExpressions.count(); ++i) {
-        if (clipboardExpressions.at(i).isEmpty()) {
-            m_clipboardAction->menu()->addSeparator();
-        } else {
-            m_clipboardAction->menu()->addAction(m_clock->evaluate(clipboardExpressions.at(i)));
+        for (int i = 0; i < m_clipboardExpressions.count(); ++i) {
+            if (m_clipboardExpressions.at(i).isEmpty()) {
+                m_clipboardAction->menu()->addSeparator();
+            } else {
+                m_clipboardAction->menu()->addAction(QString());
+            }
+
+            m_clipboardDependencies.append(-1);
+        }
+    }
+
+    const QList<QAction*> actions = m_clipboardAction->menu()->actions();
+
+    for (int i = 0; i < m_clipboardExpressions.count(); ++i) {
+        if (m_clipboardExpressions.at(i).isEmpty() || (m_clipboardDependencies.at(i) != -1 && !(m_clipboardDependencies.at(i) & m_changedComponents))) {
+            continue;
         }
+
+        int dependencies = 0;
+
+        actions.at(i)->setText(m_clock->evaluate(m_clipboardExpressions.at(i), &dependencies));
+
+        m_clipboardDependencies[i] = ((dependencies == 0 || (dependencies & (1 << MillisecondComponent))) ? -1 : dependencies);
     }
+
+    m_changedComponents = 0;
+}
+
+void Applet::updateComponent(ClockComponent component)
+{
+    m_changedComponents |= (1 << component);
 }
 
 QStringList Applet::getClipboardExpressions() const
 {
     QStringList clipboardExpressions;
-    clipboardExpressions << "Clock.getValue(Clock.Time, {'short': true})"
-    << "Clock.getValue(Clock.Time)"
+    clipboardExpressions << "%{Time:short}"
+    << "%{Time}"
     << QString()
-    << "Clock.getValue(Clock.Date, {'short': true})"
-    << "Clock.getValue(Clock.Date)"
+    << "%{Date:short}"
+    << "%{Date}"
     << QString()
-    << "Clock.getValue(Clock.DateTime, {'short': true})"
-    << "Clock.getValue(Clock.DateTime)"
-    << "Clock.getValue(Clock.Year) + '-' + Clock.getValue(Clock.Month) + '-' + Clock.getValue(Clock.DayOfMonth) + ' ' + Clock.getValue(Clock.Hour) + ':' + Clock.getValue(Clock.Minute) + ':' + Clock.getValue(Clock.Second)"
+    << "%{DateTime:short}"
+    << "%{DateTime}"
+    << "%{Year}-%{Month}-%{DayOfMonth} %{Hour}:%{Minute}:%{Second}"
     << QString()
-    << "Clock.getValue(Clock.Timestamp)";
+    << "%{Timestamp}";
 
     return config().readEntry("clipboardExpressions", clipboardExpressions);
 }
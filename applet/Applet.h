@@ -21,8 +21,14 @@
 #ifndef ADJUSTABLECLOCKAPPLET_HEADER
 #define ADJUSTABLECLOCKAPPLET_HEADER
 
+#include "DataSource.h"
+
 #include <QtCore/QList>
+#include <QtCore/QTimer>
 #include <QtCore/QDateTime>
+#include <QtGui/QPixmap>
+
+#include <KLibrary>
 
 #include <plasmaclock/clockapplet.h>
 
@@ -30,15 +36,18 @@ namespace AdjustableClock
 {
 
 class Clock;
-class DataSource;
+class Applet;
 class ThemeWidget;
 
-class Applet : public ClockApplet
+typedef void (*ConfigurationFactory)(Applet *applet, Clock *clock, KConfigDialog *parent);
+
+class ADJUSTABLECLOCK_EXPORT Applet : public ClockApplet
 {
     Q_OBJECT
 
     public:
         explicit Applet(QObject *parent, const QVariantList &args);
+        ~Applet();
 
         void init();
         QStringList getClipboardExpressions() const;
@@ -48,15 +57,20 @@ class Applet : public ClockApplet
         void createClockConfigurationInterface(KConfigDialog *parent);
         void changeEngineTimezone(const QString &oldTimeZone, const QString &newTimeZone);
         QList<QAction*> contextualActions();
+        static QString getThemeState(const QString &path);
 
     protected slots:
         void clockConfigChanged();
+        void updateTheme();
+        void finishSnapshot();
         void clockConfigAccepted();
         void copyToClipboard();
         void copyToClipboard(QAction *action);
         void toolTipAboutToShow();
         void toolTipHidden();
         void updateToolTipContent();
+        void updateToolTip(ClockComponent component);
+        void updateComponent(ClockComponent component);
         void updateClipboardMenu();
 
     private:
@@ -64,6 +78,23 @@ class Applet : public ClockApplet
         Clock *m_clock;
         ThemeWidget *m_widget;
         QAction *m_clipboardAction;
+        KLibrary *m_configurationLibrary;
+        QTimer m_toolTipTimer;
+        QPixmap m_toolTipIcon;
+        QString m_toolTipMainExpression;
+        QString m_toolTipSubExpression;
+        QString m_toolTipMainText;
+        QString m_toolTipSubText;
+        QString m_snapshotPath;
+        QString m_timeZoneState;
+        QString m_themeKey;
+        QString m_themePath;
+        QString m_themeState;
+        QMap<QString, QString> m_themeOptions;
+        QStringList m_clipboardExpressions;
+        QList<int> m_clipboardDependencies;
+        int m_toolTipDependencies;
+        int m_changedComponents;
 };
 
 }
@@ -0,0 +1,179 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#include "AssetCache.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTextStream>
+#include <QtCore/QCoreApplication>
+
+#include <KIcon>
+#include <KMimeType>
+#include <KFilterDev>
+#include <KGlobalSettings>
+
+#include <Plasma/Theme>
+
+namespace AdjustableClock
+{
+
+AssetCache* AssetCache::m_instance = NULL;
+
+AssetCache::AssetCache(QObject *parent) : QObject(parent),
+    m_hits(0),
+    m_misses(0)
+{
+    m_assets.setMaxCost(8388608);
+
+    connect(KGlobalSettings::self(), SIGNAL(iconChanged(int)), this, SLOT(clear()));
+    connect(Plasma::Theme::defaultTheme(), SIGNAL(themeChanged()), this, SLOT(clear()));
+}
+
+AssetCache* AssetCache::getInstance()
+{
+    if (!m_instance) {
+        m_instance = new AssetCache(QCoreApplication::instance());
+    }
+
+    return m_instance;
+}
+
+void AssetCache::clear()
+{
+    m_assets.clear();
+}
+
+Asset AssetCache::getFile(const QString &path, AssetEncoding encoding)
+{
+    const QFileInfo fileInfo(path);
+
+    if (!fileInfo.isFile()) {
+        return Asset();
+    }
+
+    const QString key = QString("file:%1:%2:%3:%4").arg(encoding).arg(fileInfo.lastModified().toTime_t()).arg(fileInfo.size()).arg(fileInfo.absoluteFilePath());
+    Asset asset;
+
+    if (findAsset(key, asset)) {
+        return asset;
+    }
+
+    if (encoding != RawEncoding) {
+        asset = encodeAsset(getFile(path), encoding);
+    } else {
+        QScopedPointer<QIODevice> file(KFilterDev::deviceForFile(fileInfo.absoluteFilePath(), "application/x-gzip"));
+
+        if (!file->open(QIODevice::ReadOnly)) {
+            return Asset();
+        }
+
+        asset.data = file->readAll();
+        asset.mimeType = KMimeType::findByPath(fileInfo.absoluteFilePath())->name();
+
+        if (asset.mimeType.contains(QLatin1String("svg"))) {
+            asset.mimeType = QLatin1String("image/svg+xml");
+        }
+    }
+
+    insertAsset(key, asset);
+
+    return asset;
+}
+
+Asset AssetCache::getIcon(const QString &name, int size, AssetEncoding encoding)
+{
+    const QString key = QString("icon:%1:%2:%3").arg(encoding).arg(size).arg(name);
+    Asset asset;
+
+    if (findAsset(key, asset)) {
+        return asset;
+    }
+
+    if (encoding != RawEncoding) {
+        asset = encodeAsset(getIcon(name, size), encoding);
+    } else {
+        QBuffer buffer(&asset.data);
+
+        KIcon(name).pixmap(size, size).save(&buffer, "PNG");
+
+        asset.mimeType = QLatin1String("image/png");
+    }
+
+    insertAsset(key, asset);
+
+    return asset;
+}
+
+bool AssetCache::findAsset(const QString &key, Asset &asset)
+{
+    const Asset *cachedAsset = m_assets.object(key);
+
+    if (!cachedAsset) {
+        ++m_misses;
+
+        return false;
+    }
+
+    ++m_hits;
+
+    asset = *cachedAsset;
+
+    return true;
+}
+
+Asset AssetCache::encodeAsset(const Asset &asset, AssetEncoding encoding) const
+{
+    Asset encodedAsset;
+    encodedAsset.mimeType = asset.mimeType;
+
+    if (encoding == DataUriEncoding) {
+        encodedAsset.text = QString("data:%1;base64,%2").arg(asset.mimeType).arg(QString(asset.data.toBase64()));
+    } else {
+        QTextStream stream(asset.data);
+        stream.setCodec("UTF-8");
+
+        encodedAsset.text = stream.readAll();
+    }
+
+    return encodedAsset;
+}
+
+void AssetCache::insertAsset(const QString &key, const Asset &asset)
+{
+    if (asset.mimeType.isEmpty()) {
+        return;
+    }
+
+    m_assets.insert(key, new Asset(asset), qMax(1, (asset.data.size() + (asset.text.size() * 2))));
+}
+
+int AssetCache::getHitCount() const
+{
+    return m_hits;
+}
+
+int AssetCache::getMissCount() const
+{
+    return m_misses;
+}
+
+}
@@ -0,0 +1,75 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#ifndef ADJUSTABLECLOCKASSETCACHE_HEADER
+#define ADJUSTABLECLOCKASSETCACHE_HEADER
+
+#include <QtCore/QCache>
+#include <QtCore/QObject>
+
+namespace AdjustableClock
+{
+
+enum AssetEncoding
+{
+    RawEncoding = 0,
+    TextEncoding = 1,
+    DataUriEncoding = 2
+};
+
+struct Asset
+{
+    QByteArray data;
+    QString text;
+    QString mimeType;
+};
+
+class AssetCache : public QObject
+{
+    Q_OBJECT
+
+    public:
+        static AssetCache* getInstance();
+        Asset getFile(const QString &path, AssetEncoding encoding = RawEncoding);
+        Asset getIcon(const QString &name, int size, AssetEncoding encoding = RawEncoding);
+        int getHitCount() const;
+        int getMissCount() const;
+
+    protected:
+        explicit AssetCache(QObject *parent = NULL);
+
+        bool findAsset(const QString &key, Asset &asset);
+        Asset encodeAsset(const Asset &asset, AssetEncoding encoding) const;
+        void insertAsset(const QString &key, const Asset &asset);
+
+    protected slots:
+        void clear();
+
+    private:
+        QCache<QString, Asset> m_assets;
+        int m_hits;
+        int m_misses;
+
+        static AssetCache *m_instance;
+};
+
+}
+
+#endif
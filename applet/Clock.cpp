@@ -19,29 +19,93 @@
 ***********************************************************************************/
 
 #include "Clock.h"
+#include "AssetCache.h"
+#include "Format.h"
 
 #include <QtCore/QDir>
-#include <QtCore/QBuffer>
+#include <QtCore/QUrl>
+#include <QtCore/QElapsedTimer>
 
-#include <KIcon>
-#include <KMimeType>
-#include <KFilterDev>
+#include <KLocalizedString>
 
 #include <Plasma/Theme>
 
 namespace AdjustableClock
 {
 
+struct ComponentDefinition
+{
+    const char *name;
+    const char *title;
+    int capabilities;
+    ComponentGranularity granularity;
+};
+
+static const ComponentDefinition components[] = {
+    {"", "", NoCapability, EventGranularity},
+    {"Second", I18N_NOOP("Second"), ShortFormCapability, SecondGranularity},
+    {"Minute", I18N_NOOP("Minute"), ShortFormCapability, MinuteGranularity},
+    {"Hour", I18N_NOOP("Hour"), (ShortFormCapability | AlternativeFormCapability), HourGranularity},
+    {"TimeOfDay", I18N_NOOP("The pm or am string"), NoCapability, HourGranularity},
+    {"DayOfWeek", I18N_NOOP("Weekday"), (ShortFormCapability | TextualFormCapability), DayGranularity},
+    {"DayOfMonth", I18N_NOOP("Day of the month"), ShortFormCapability, DayGranularity},
+    {"DayOfYear", I18N_NOOP("Day of the year"), ShortFormCapability, DayGranularity},
+    {"Week", I18N_NOOP("Week"), ShortFormCapability, DayGranularity},
+    {"Month", I18N_NOOP("Month"), (ShortFormCapability | TextualFormCapability | PossessiveFormCapability), DayGranularity},
+    {"Year", I18N_NOOP("Year"), ShortFormCapability, DayGranularity},
+    {"Timestamp", I18N_NOOP("UNIX timestamp"), MillisecondsCapability, SecondGranularity},
+    {"Time", I18N_NOOP("Time"), ShortFormCapability, SecondGranularity},
+    {"Date", I18N_NOOP("Date"), ShortFormCapability, DayGranularity},
+    {"DateTime", I18N_NOOP("Date and time"), ShortFormCapability, SecondGranularity},
+    {"TimeZoneName", I18N_NOOP("Timezone name"), NoCapability, EventGranularity},
+    {"TimeZoneAbbreviation", I18N_NOOP("Timezone abbreviation"), NoCapability, EventGranularity},
+    {"TimeZoneOffset", I18N_NOOP("Timezone offset"), NoCapability, EventGranularity},
+    {"TimeZones", I18N_NOOP("Timezones list"), NoCapability, MinuteGranularity},
+    {"Events", I18N_NOOP("Events list"), ShortFormCapability, EventGranularity},
+    {"Holidays", I18N_NOOP("Holidays list"), ShortFormCapability, EventGranularity},
+    {"Sunrise", I18N_NOOP("Sunrise time"), NoCapability, EventGranularity},
+    {"Sunset", I18N_NOOP("Sunset time"), NoCapability, EventGranularity},
+    {"Millisecond", I18N_NOOP("Millisecond"), ShortFormCapability, FrameGranularity}
+//     {"ForecastDuration", I18N_NOOP("Forecast availability in days"), NoCapability, EventGranularity},
+//     {"TemperatureCurrent", I18N_NOOP("Current temperature"), NoCapability, EventGranularity},
+//     {"TemperatureMinimum", I18N_NOOP("Minimum temperature"), NoCapability, EventGranularity},
+//     {"TemperatureMaximum", I18N_NOOP("Maximum temperature"), NoCapability, EventGranularity},
+//     {"Conditions", I18N_NOOP("Conditions"), NoCapability, EventGranularity},
+//     {"WindDirection", I18N_NOOP("Direction of the wind"), NoCapability, EventGranularity},
+//     {"WindSpeed", I18N_NOOP("Speed of the wind"), NoCapability, EventGranularity},
+//     {"Pressure", I18N_NOOP("Pressure"), NoCapability, EventGranularity},
+//     {"Humidity", I18N_NOOP("Humidity"), NoCapability, EventGranularity},
+//     {"Location", I18N_NOOP("Location"), NoCapability, EventGranularity}
+};
+
+// Perfect hash of component names: slot = ((length * 7) + first + (last * 11)) % 35,
+// where first and last are the UTF-16 codes of the first and last character.
+// Names must be 4 to 20 characters long. Regenerate it after adding a component by
+// computing the slot of every name in components[] and storing its index there,
+// changing the multipliers or the table size if two names share a slot.
+// The Clock constructor asserts that every name maps back to its own index.
+static const int componentSlots[35] = {1, 22, 0, 0, 0, 2, 10, 0, 4, 0, 14, 19, 18, 5, 11, 0, 0, 13, 21, 15, 7, 0, 6, 17, 3, 0, 0, 0, 20, 23, 0, 9, 8, 12, 16};
+
 Clock::Clock(DataSource *source, bool constant) : QObject(source),
     m_source(source),
+    m_engine(NULL),
     m_type(UnknownType),
+    m_dependencies(0),
+    m_timeBudget(250),
+    m_evaluationOverruns(0),
     m_constant(constant)
 {
-    m_engine.globalObject().setProperty("Clock", m_engine.newQObject(this), QScriptValue::Undeletable);
-
-    for (int i = 1; i < LastComponent; ++i) {
-        m_engine.evaluate(QString("Clock.%1 = %2;").arg(getComponentString(static_cast<ClockComponent>(i))).arg(i));
+#ifndef QT_NO_DEBUG
+    for (int i = (InvalidComponent + 1); i < LastComponent; ++i) {
+        Q_ASSERT_X(getComponent(QLatin1String(components[i].name)) == i, "Clock", "componentSlots has to be regenerated");
     }
+#endif
+
+    m_formats.setMaxCost(100);
+    m_results.setMaxCost(100);
+    m_watchdogTimer.setSingleShot(true);
+
+    connect(&m_watchdogTimer, SIGNAL(timeout()), this, SLOT(abortEvaluation()));
 
     if (!constant) {
         connect(m_source, SIGNAL(componentChanged(ClockComponent)), this, SIGNAL(componentChanged(ClockComponent)));
@@ -55,6 +119,28 @@ void Clock::setTheme(const QString &path, ThemeType type)
     m_type = type;
 }
 
+void Clock::setPrediction(bool enabled)
+{
+    if (!m_constant) {
+        m_source->setPrediction(enabled);
+    }
+}
+
+QList<ClockComponent> Clock::getPredictedComponents() const
+{
+    return (m_constant ? QList<ClockComponent>() : m_source->getPredictedComponents());
+}
+
+QDateTime Clock::getDateTime() const
+{
+    return m_source->getDateTime();
+}
+
+QString Clock::getPath() const
+{
+    return m_path;
+}
+
 QVariant Clock::getColor(const QString &role) const
 {
     Plasma::Theme::ColorRole nativeRole = Plasma::Theme::TextColor;
@@ -98,21 +184,26 @@ QVariant Clock::getFile(const QString &path, bool base64) const
 {
     QString filePath = path;
 
-    if (QFileInfo(filePath).isRelative()) {
-        filePath = QFileInfo(QDir(m_path).absoluteFilePath(filePath)).absolutePath();
-    }
+    if (m_type == HtmlType && base64) {
+        QUrl url;
+        url.setScheme(QLatin1String("clock"));
 
-    QScopedPointer<QIODevice> file(KFilterDev::deviceForFile(filePath, "application/x-gzip"));
-    file->open(QIODevice::ReadOnly);
+        if (QFileInfo(filePath).isRelative()) {
+            url.setHost(QLatin1String("theme"));
+            url.setPath(QLatin1Char('/') + filePath);
+        } else {
+            url.setHost(QLatin1String("file"));
+            url.setPath(filePath);
+        }
 
-    if (base64) {
-        return QString("data:%1;base64,%2").arg(KMimeType::findByPath(filePath)->name()).arg(QString(file->readAll().toBase64()));
+        return url.toString();
     }
 
-    QTextStream stream(file.data());
-    stream.setCodec("UTF-8");
+    if (QFileInfo(filePath).isRelative()) {
+        filePath = QDir(m_path).absoluteFilePath(filePath);
+    }
 
-    return stream.readAll();
+    return AssetCache::getInstance()->getFile(filePath, (base64 ? DataUriEncoding : TextEncoding)).text;
 }
 
 QVariant Clock::getFont(const QString &role) const
@@ -134,34 +225,34 @@ QVariant Clock::getFont(const QString &role) const
 
 QVariant Clock::getIcon(const QString &path, int size) const
 {
-    const KIcon icon(path);
-    QByteArray byteArray;
-    QBuffer buffer(&byteArray);
+    if (m_type == QmlType) {
+        return QString("image://adjustableclock/icon/%1/%2").arg(size).arg(path);
+    }
 
-    icon.pixmap(size, size).save(&buffer, "PNG");
+    if (m_type == HtmlType) {
+        return QString("clock://icon/%1/%2").arg(size).arg(path);
+    }
 
-    return QString("data:image/png;base64," + byteArray.toBase64());
+    return AssetCache::getInstance()->getIcon(path, size, DataUriEncoding).text;
 }
 
 QVariant Clock::getImage(const QString &path, bool base64) const
 {
+    if (m_type == QmlType && base64) {
+        return QString("image://adjustableclock/image/%1").arg(path);
+    }
+
     const QString imagePath = Plasma::Theme::defaultTheme()->imagePath(path);
 
     if (imagePath.isEmpty()) {
         return QString();
     }
 
-    QScopedPointer<QIODevice> file(KFilterDev::deviceForFile(imagePath, "application/x-gzip"));
-    file->open(QIODevice::ReadOnly);
-
-    if (base64) {
-        return QString("data:image/svg+xml;base64," + QString(file->readAll().toBase64()));
+    if (m_type == HtmlType && base64) {
+        return QString("clock://image/%1").arg(path);
     }
 
-    QTextStream stream(file.data());
-    stream.setCodec("UTF-8");
-
-    return stream.readAll();
+    return AssetCache::getInstance()->getFile(imagePath, (base64 ? DataUriEncoding : TextEncoding)).text;
 }
 
 QVariant Clock::getOption(const QString &key, const QVariant &defaultValue) const
@@ -183,162 +274,187 @@ QVariant Clock::getOption(const QString &key, const QVariant &defaultValue) cons
     return value;
 }
 
+QVariantMap Clock::getOptions() const
+{
+    return m_source->getOptions(m_theme);
+}
+
 QVariant Clock::getValue(int component, const QVariantMap &options) const
 {
-    return m_source->getValue(static_cast<ClockComponent>(component), options, m_constant);
+    if (component <= InvalidComponent || component >= LastComponent) {
+        return QVariant();
+    }
+
+    m_dependencies |= (1 << component);
+
+    return m_source->getValue(static_cast<ClockComponent>(component), ComponentOptions::fromMap(options), m_constant);
+}
+
+QVariant Clock::getValue(ClockComponent component, const ComponentOptions &options) const
+{
+    m_dependencies |= (1 << component);
+
+    return m_source->getValue(component, options, m_constant);
+}
+
+void Clock::setFrameRate(int rate)
+{
+    emit frameRateChanged(rate);
+}
+
+QString Clock::evaluate(const QString &script, int *dependencies)
+{
+    const int outerDependencies = m_dependencies;
+
+    m_dependencies = 0;
+
+    Format *cachedFormat = m_formats.object(script);
+
+    if (!cachedFormat) {
+        cachedFormat = new Format();
+        cachedFormat->compile(script);
+
+        m_formats.insert(script, cachedFormat);
+    }
+
+    const Format format = *cachedFormat;
+    QString result;
+
+    if (format.isValid()) {
+        result = format.evaluate(this);
+    } else if (!format.getError().isEmpty()) {
+        result = format.getError();
+    } else if (getEngine()->isEvaluating()) {
+        const EvaluationResult *cachedResult = m_results.object(script);
+
+        if (cachedResult) {
+            result = cachedResult->text;
+
+            m_dependencies = cachedResult->dependencies;
+        }
+    } else {
+        QElapsedTimer timer;
+        timer.start();
+
+        m_watchdogTimer.start(m_timeBudget);
+
+        const QScriptValue value = m_engine->evaluate(script);
+
+        if (m_watchdogTimer.isActive()) {
+            result = value.toString();
+
+            EvaluationResult *evaluationResult = new EvaluationResult();
+            evaluationResult->text = result;
+            evaluationResult->dependencies = m_dependencies;
+
+            m_results.insert(script, evaluationResult);
+        }
+
+        m_watchdogTimer.stop();
+
+        if (timer.elapsed() > m_timeBudget) {
+            ++m_evaluationOverruns;
+
+            emit evaluationBudgetExceeded(script);
+        }
+    }
+
+    if (dependencies) {
+        *dependencies = m_dependencies;
+    }
+
+    m_dependencies = outerDependencies;
+
+    return result;
+}
+
+void Clock::abortEvaluation()
+{
+    if (m_engine && m_engine->isEvaluating()) {
+        m_engine->abortEvaluation();
+    }
+}
+
+void Clock::setTimeBudget(int budget)
+{
+    m_timeBudget = qMax(10, budget);
+
+    if (m_engine) {
+        m_engine->setProcessEventsInterval(qMax(5, (m_timeBudget / 5)));
+    }
 }
 
-QString Clock::evaluate(const QString &script)
+int Clock::getEvaluationOverruns() const
 {
-    return m_engine.evaluate(script).toString();
+    return m_evaluationOverruns;
+}
+
+QScriptEngine* Clock::getEngine()
+{
+    if (!m_engine) {
+        m_engine = new QScriptEngine(this);
+        m_engine->setProcessEventsInterval(qMax(5, (m_timeBudget / 5)));
+
+        QScriptValue clock = m_engine->newQObject(this);
+
+        for (int i = 1; i < LastComponent; ++i) {
+            clock.setProperty(getComponentString(static_cast<ClockComponent>(i)), i, (QScriptValue::ReadOnly | QScriptValue::Undeletable));
+        }
+
+        m_engine->globalObject().setProperty("Clock", clock, QScriptValue::Undeletable);
+    }
+
+    return m_engine;
 }
 
 QString Clock::getComponentName(ClockComponent component)
 {
-    switch (component) {
-    case SecondComponent:
-        return i18n("Second");
-    case MinuteComponent:
-        return i18n("Minute");
-    case HourComponent:
-        return i18n("Hour");
-    case TimeOfDayComponent:
-        return i18n("The pm or am string");
-    case DayOfMonthComponent:
-        return i18n("Day of the month");
-    case DayOfWeekComponent:
-        return i18n("Weekday");
-    case DayOfYearComponent:
-        return i18n("Day of the year");
-    case WeekComponent:
-        return i18n("Week");
-    case MonthComponent:
-        return i18n("Month");
-    case YearComponent:
-        return i18n("Year");
-    case TimestampComponent:
-        return i18n("UNIX timestamp");
-    case TimeComponent:
-        return i18n("Time");
-    case DateComponent:
-        return i18n("Date");
-    case DateTimeComponent:
-        return i18n("Date and time");
-    case TimeZoneNameComponent:
-        return i18n("Timezone name");
-    case TimeZoneAbbreviationComponent:
-        return i18n("Timezone abbreviation");
-    case TimeZoneOffsetComponent:
-        return i18n("Timezone offset");
-    case TimeZonesComponent:
-        return i18n("Timezones list");
-    case EventsComponent:
-        return i18n("Events list");
-    case HolidaysComponent:
-        return i18n("Holidays list");
-    case SunriseComponent:
-        return i18n("Sunrise time");
-    case SunsetComponent:
-        return i18n("Sunset time");
-//     case ForecastDurationComponent:
-//         return i18n("Forecast availability in days");
-//     case TemperatureCurrentComponent:
-//         return i18n("Current temperature");
-//     case TemperatureMinimumComponent:
-//         return i18n("Minimum temperature");
-//     case TemperatureMaximumComponent:
-//         return i18n("Maximum temperature");
-//     case ConditionsComponent:
-//         return i18n("Conditions");
-//     case WindDirectionComponent:
-//         return i18n("Direction of the wind");
-//     case WindSpeedComponent:
-//         return i18n("Speed of the wind");
-//     case PressureComponent:
-//         return i18n("Pressure");
-//     case HumidityComponent:
-//         return i18n("Humidity");
-//     case LocationComponent:
-//         return i18n("Location");
-    default:
+    if (component <= InvalidComponent || component >= LastComponent) {
         return QString();
     }
 
-    return QString();
+    return i18n(components[component].title);
 }
 
 QLatin1String Clock::getComponentString(ClockComponent component)
 {
-    switch (component) {
-    case SecondComponent:
-        return QLatin1String("Second");
-    case MinuteComponent:
-        return QLatin1String("Minute");
-    case HourComponent:
-        return QLatin1String("Hour");
-    case TimeOfDayComponent:
-        return QLatin1String("TimeOfDay");
-    case DayOfMonthComponent:
-        return QLatin1String("DayOfMonth");
-    case DayOfWeekComponent:
-        return QLatin1String("DayOfWeek");
-    case DayOfYearComponent:
-        return QLatin1String("DayOfYear");
-    case WeekComponent:
-        return QLatin1String("Week");
-    case MonthComponent:
-        return QLatin1String("Month");
-    case YearComponent:
-        return QLatin1String("Year");
-    case TimestampComponent:
-        return QLatin1String("Timestamp");
-    case TimeComponent:
-        return QLatin1String("Time");
-    case DateComponent:
-        return QLatin1String("Date");
-    case DateTimeComponent:
-        return QLatin1String("DateTime");
-    case TimeZoneNameComponent:
-        return QLatin1String("TimeZoneName");
-    case TimeZoneAbbreviationComponent:
-        return QLatin1String("TimeZoneAbbreviation");
-    case TimeZoneOffsetComponent:
-        return QLatin1String("TimeZoneOffset");
-    case TimeZonesComponent:
-        return QLatin1String("TimeZones");
-    case EventsComponent:
-        return QLatin1String("Events");
-    case HolidaysComponent:
-        return QLatin1String("Holidays");
-    case SunriseComponent:
-        return QLatin1String("Sunrise");
-    case SunsetComponent:
-        return QLatin1String("Sunset");
-//     case ForecastDurationComponent:
-//         return QLatin1String("ForecastDuration");
-//     case TemperatureCurrentComponent:
-//         return QLatin1String("TemperatureCurrent");
-//     case TemperatureMinimumComponent:
-//         return QLatin1String("TemperatureMinimum");
-//     case TemperatureMaximumComponent:
-//         return QLatin1String("TemperatureMaximum");
-//     case ConditionsComponent:
-//         return QLatin1String("Conditions");
-//     case WindDirectionComponent:
-//         return QLatin1String("WindDirection");
-//     case WindSpeedComponent:
-//         return QLatin1String("WindSpeed");
-//     case PressureComponent:
-//         return QLatin1String("Pressure");
-//     case HumidityComponent:
-//         return QLatin1String("Humidity");
-//     case LocationComponent:
-//         return QLatin1String("Location");
-    default:
+    if (component <= InvalidComponent || component >= LastComponent) {
         return QLatin1String("");
     }
 
-    return QLatin1String("");
+    return QLatin1String(components[component].name);
+}
+
+ClockComponent Clock::getComponent(const QString &name)
+{
+    const int length = name.length();
+
+    if (length < 4 || length > 20) {
+        return InvalidComponent;
+    }
+
+    const int slot = (((length * 7) + name.at(0).unicode() + (name.at(length - 1).unicode() * 11)) % 35);
+    const ClockComponent component = static_cast<ClockComponent>(componentSlots[slot]);
+
+    return ((component != InvalidComponent && name == QLatin1String(components[component].name)) ? component : InvalidComponent);
+}
+
+int Clock::getComponentCapabilities(ClockComponent component)
+{
+    if (component <= InvalidComponent || component >= LastComponent) {
+        return NoCapability;
+    }
+
+    return components[component].capabilities;
+}
+
+ComponentGranularity Clock::getComponentGranularity(ClockComponent component)
+{
+    if (component <= InvalidComponent || component >= LastComponent) {
+        return EventGranularity;
+    }
+
+    return components[component].granularity;
 }
 
 }
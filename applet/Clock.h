@@ -22,7 +22,10 @@
 #define ADJUSTABLECLOCKCLOCK_HEADER
 
 #include "DataSource.h"
+#include "Format.h"
 
+#include <QtCore/QCache>
+#include <QtCore/QTimer>
 #include <QtScript/QScriptEngine>
 
 namespace AdjustableClock
@@ -32,10 +35,37 @@ enum ThemeType
 {
     UnknownType = 0,
     HtmlType = 1,
-    QmlType = 2
+    QmlType = 2,
+    NativeType = 3
 };
 
-class Clock : public QObject
+enum ComponentCapability
+{
+    NoCapability = 0,
+    ShortFormCapability = 1,
+    TextualFormCapability = 2,
+    PossessiveFormCapability = 4,
+    AlternativeFormCapability = 8,
+    MillisecondsCapability = 16
+};
+
+enum ComponentGranularity
+{
+    FrameGranularity = 0,
+    SecondGranularity = 1,
+    MinuteGranularity = 2,
+    HourGranularity = 3,
+    DayGranularity = 4,
+    EventGranularity = 5
+};
+
+struct EvaluationResult
+{
+    QString text;
+    int dependencies;
+};
+
+class ADJUSTABLECLOCK_EXPORT Clock : public QObject
 {
     Q_OBJECT
 
@@ -43,27 +73,53 @@ class Clock : public QObject
         explicit Clock(DataSource *source, bool constant = false);
 
         void setTheme(const QString &path, ThemeType type);
+        void setPrediction(bool enabled);
+        QList<ClockComponent> getPredictedComponents() const;
+        QDateTime getDateTime() const;
+        QString getPath() const;
         Q_INVOKABLE QVariant getColor(const QString &role = QString()) const;
         Q_INVOKABLE QVariant getFile(const QString &path, bool base64 = true) const;
         Q_INVOKABLE QVariant getFont(const QString &role = QString()) const;
         Q_INVOKABLE QVariant getIcon(const QString &path, int size = 64) const;
         Q_INVOKABLE QVariant getImage(const QString &path, bool base64 = true) const;
         Q_INVOKABLE QVariant getOption(const QString &key, const QVariant &defaultValue = QVariant()) const;
+        QVariantMap getOptions() const;
         Q_INVOKABLE QVariant getValue(int component, const QVariantMap &options = QVariantMap()) const;
-        QString evaluate(const QString &script);
+        QVariant getValue(ClockComponent component, const ComponentOptions &options) const;
+        Q_INVOKABLE void setFrameRate(int rate);
+        void setTimeBudget(int budget);
+        int getEvaluationOverruns() const;
+        QString evaluate(const QString &script, int *dependencies = NULL);
         static QString getComponentName(ClockComponent component);
         static QLatin1String getComponentString(ClockComponent component);
+        static ClockComponent getComponent(const QString &name);
+        static int getComponentCapabilities(ClockComponent component);
+        static ComponentGranularity getComponentGranularity(ClockComponent component);
+
+    protected:
+        QScriptEngine* getEngine();
+
+    protected slots:
+        void abortEvaluation();
 
     private:
         DataSource *m_source;
-        QScriptEngine m_engine;
+        QScriptEngine *m_engine;
+        QCache<QString, Format> m_formats;
+        QCache<QString, EvaluationResult> m_results;
+        QTimer m_watchdogTimer;
         QString m_path;
         QString m_theme;
         ThemeType m_type;
+        mutable int m_dependencies;
+        int m_timeBudget;
+        int m_evaluationOverruns;
         bool m_constant;
 
     signals:
         void componentChanged(ClockComponent component);
+        void frameRateChanged(int rate);
+        void evaluationBudgetExceeded(const QString &script);
 };
 
 }
@@ -0,0 +1,527 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#include "ClockContext.h"
+#include "Clock.h"
+
+namespace AdjustableClock
+{
+
+ClockContext::ClockContext(Clock *clock, QObject *parent) : QObject(parent),
+    m_clock(clock),
+    m_loaded(LastProperty)
+{
+    for (int i = 0; i < LastProperty; ++i) {
+        m_values.append(QString());
+    }
+}
+
+void ClockContext::updateComponent(ClockComponent component)
+{
+    bool changed = false;
+
+    for (int i = 0; i < LastProperty; ++i) {
+        if (!m_loaded.testBit(i) || getPropertyComponent(static_cast<ContextProperty>(i)) != component) {
+            continue;
+        }
+
+        const QString value = m_clock->getValue(component, getPropertyOptions(static_cast<ContextProperty>(i))).toString();
+
+        if (value != m_values.at(i)) {
+            m_values[i] = value;
+
+            changed = true;
+        }
+    }
+
+    if (!changed) {
+        return;
+    }
+
+    switch (component) {
+    case SecondComponent:
+        emit secondChanged();
+
+        break;
+    case MinuteComponent:
+        emit minuteChanged();
+
+        break;
+    case HourComponent:
+        emit hourChanged();
+
+        break;
+    case MillisecondComponent:
+        emit millisecondChanged();
+
+        break;
+    case TimeOfDayComponent:
+        emit timeOfDayChanged();
+
+        break;
+    case DayOfWeekComponent:
+        emit dayOfWeekChanged();
+
+        break;
+    case DayOfMonthComponent:
+        emit dayOfMonthChanged();
+
+        break;
+    case DayOfYearComponent:
+        emit dayOfYearChanged();
+
+        break;
+    case WeekComponent:
+        emit weekChanged();
+
+        break;
+    case MonthComponent:
+        emit monthChanged();
+
+        break;
+    case YearComponent:
+        emit yearChanged();
+
+        break;
+    case TimestampComponent:
+        emit timestampChanged();
+
+        break;
+    case TimeComponent:
+        emit timeChanged();
+
+        break;
+    case DateComponent:
+        emit dateChanged();
+
+        break;
+    case DateTimeComponent:
+        emit dateTimeChanged();
+
+        break;
+    case TimeZoneNameComponent:
+        emit timeZoneNameChanged();
+
+        break;
+    case TimeZoneAbbreviationComponent:
+        emit timeZoneAbbreviationChanged();
+
+        break;
+    case TimeZoneOffsetComponent:
+        emit timeZoneOffsetChanged();
+
+        break;
+    case TimeZonesComponent:
+        emit timeZonesChanged();
+
+        break;
+    case EventsComponent:
+        emit eventsChanged();
+
+        break;
+    case HolidaysComponent:
+        emit holidaysChanged();
+
+        break;
+    case SunriseComponent:
+        emit sunriseChanged();
+
+        break;
+    case SunsetComponent:
+        emit sunsetChanged();
+
+        break;
+    default:
+        break;
+    }
+}
+
+void ClockContext::updateOptions()
+{
+    const QVariantMap options = m_clock->getOptions();
+
+    if (options != m_options) {
+        m_options = options;
+
+        emit optionsChanged();
+    }
+}
+
+QString ClockContext::getValue(ContextProperty property) const
+{
+    if (!m_loaded.testBit(property)) {
+        m_values[property] = m_clock->getValue(getPropertyComponent(property), getPropertyOptions(property)).toString();
+
+        m_loaded.setBit(property);
+    }
+
+    return m_values.at(property);
+}
+
+QString ClockContext::getSecond() const
+{
+    return getValue(SecondProperty);
+}
+
+QString ClockContext::getSecondShort() const
+{
+    return getValue(SecondShortProperty);
+}
+
+QString ClockContext::getMinute() const
+{
+    return getValue(MinuteProperty);
+}
+
+QString ClockContext::getMinuteShort() const
+{
+    return getValue(MinuteShortProperty);
+}
+
+QString ClockContext::getHour() const
+{
+    return getValue(HourProperty);
+}
+
+QString ClockContext::getHourShort() const
+{
+    return getValue(HourShortProperty);
+}
+
+QString ClockContext::getHour12() const
+{
+    return getValue(Hour12Property);
+}
+
+QString ClockContext::getHour24() const
+{
+    return getValue(Hour24Property);
+}
+
+QString ClockContext::getMillisecond() const
+{
+    return getValue(MillisecondProperty);
+}
+
+QString ClockContext::getTimeOfDay() const
+{
+    return getValue(TimeOfDayProperty);
+}
+
+QString ClockContext::getDayOfWeek() const
+{
+    return getValue(DayOfWeekProperty);
+}
+
+QString ClockContext::getDayOfWeekName() const
+{
+    return getValue(DayOfWeekNameProperty);
+}
+
+QString ClockContext::getDayOfWeekShortName() const
+{
+    return getValue(DayOfWeekShortNameProperty);
+}
+
+QString ClockContext::getDayOfMonth() const
+{
+    return getValue(DayOfMonthProperty);
+}
+
+QString ClockContext::getDayOfMonthShort() const
+{
+    return getValue(DayOfMonthShortProperty);
+}
+
+QString ClockContext::getDayOfYear() const
+{
+    return getValue(DayOfYearProperty);
+}
+
+QString ClockContext::getWeek() const
+{
+    return getValue(WeekProperty);
+}
+
+QString ClockContext::getMonth() const
+{
+    return getValue(MonthProperty);
+}
+
+QString ClockContext::getMonthShort() const
+{
+    return getValue(MonthShortProperty);
+}
+
+QString ClockContext::getMonthName() const
+{
+    return getValue(MonthNameProperty);
+}
+
+QString ClockContext::getMonthShortName() const
+{
+    return getValue(MonthShortNameProperty);
+}
+
+QString ClockContext::getYear() const
+{
+    return getValue(YearProperty);
+}
+
+QString ClockContext::getYearShort() const
+{
+    return getValue(YearShortProperty);
+}
+
+QString ClockContext::getTimestamp() const
+{
+    return getValue(TimestampProperty);
+}
+
+QString ClockContext::getTime() const
+{
+    return getValue(TimeProperty);
+}
+
+QString ClockContext::getTimeShort() const
+{
+    return getValue(TimeShortProperty);
+}
+
+QString ClockContext::getDate() const
+{
+    return getValue(DateProperty);
+}
+
+QString ClockContext::getDateShort() const
+{
+    return getValue(DateShortProperty);
+}
+
+QString ClockContext::getDateTime() const
+{
+    return getValue(DateTimeProperty);
+}
+
+QString ClockContext::getDateTimeShort() const
+{
+    return getValue(DateTimeShortProperty);
+}
+
+QString ClockContext::getTimeZoneName() const
+{
+    return getValue(TimeZoneNameProperty);
+}
+
+QString ClockContext::getTimeZoneAbbreviation() const
+{
+    return getValue(TimeZoneAbbreviationProperty);
+}
+
+QString ClockContext::getTimeZoneOffset() const
+{
+    return getValue(TimeZoneOffsetProperty);
+}
+
+QString ClockContext::getTimeZones() const
+{
+    return getValue(TimeZonesProperty);
+}
+
+QString ClockContext::getEvents() const
+{
+    return getValue(EventsProperty);
+}
+
+QString ClockContext::getEventsShort() const
+{
+    return getValue(EventsShortProperty);
+}
+
+QString ClockContext::getHolidays() const
+{
+    return getValue(HolidaysProperty);
+}
+
+QString ClockContext::getHoliday() const
+{
+    return getValue(HolidayProperty);
+}
+
+QString ClockContext::getSunrise() const
+{
+    return getValue(SunriseProperty);
+}
+
+QString ClockContext::getSunset() const
+{
+    return getValue(SunsetProperty);
+}
+
+QVariantMap ClockContext::getOptions() const
+{
+    return m_options;
+}
+
+QString ClockContext::getPropertyName(ClockComponent component, const ComponentOptions &options)
+{
+    QString name;
+    int bestMatch = -1;
+
+    for (int i = 0; i < LastProperty; ++i) {
+        if (getPropertyComponent(static_cast<ContextProperty>(i)) != component) {
+            continue;
+        }
+
+        const ComponentOptions propertyOptions = getPropertyOptions(static_cast<ContextProperty>(i));
+
+        if ((options.flags & propertyOptions.flags) != propertyOptions.flags || (propertyOptions.alternative != DefaultState && propertyOptions.alternative != options.alternative) || (propertyOptions.possessive != DefaultState && propertyOptions.possessive != options.possessive)) {
+            continue;
+        }
+
+        const int match = propertyOptions.getCount();
+
+        if (match > bestMatch) {
+            bestMatch = match;
+            name = QLatin1String(staticMetaObject.property(staticMetaObject.propertyOffset() + i).name());
+        }
+    }
+
+    return name;
+}
+
+ClockComponent ClockContext::getPropertyComponent(ContextProperty property)
+{
+    switch (property) {
+    case SecondProperty:
+    case SecondShortProperty:
+        return SecondComponent;
+    case MinuteProperty:
+    case MinuteShortProperty:
+        return MinuteComponent;
+    case HourProperty:
+    case HourShortProperty:
+    case Hour12Property:
+    case Hour24Property:
+        return HourComponent;
+    case MillisecondProperty:
+        return MillisecondComponent;
+    case TimeOfDayProperty:
+        return TimeOfDayComponent;
+    case DayOfWeekProperty:
+    case DayOfWeekNameProperty:
+    case DayOfWeekShortNameProperty:
+        return DayOfWeekComponent;
+    case DayOfMonthProperty:
+    case DayOfMonthShortProperty:
+        return DayOfMonthComponent;
+    case DayOfYearProperty:
+        return DayOfYearComponent;
+    case WeekProperty:
+        return WeekComponent;
+    case MonthProperty:
+    case MonthShortProperty:
+    case MonthNameProperty:
+    case MonthShortNameProperty:
+        return MonthComponent;
+    case YearProperty:
+    case YearShortProperty:
+        return YearComponent;
+    case TimestampProperty:
+        return TimestampComponent;
+    case TimeProperty:
+    case TimeShortProperty:
+        return TimeComponent;
+    case DateProperty:
+    case DateShortProperty:
+        return DateComponent;
+    case DateTimeProperty:
+    case DateTimeShortProperty:
+        return DateTimeComponent;
+    case TimeZoneNameProperty:
+        return TimeZoneNameComponent;
+    case TimeZoneAbbreviationProperty:
+        return TimeZoneAbbreviationComponent;
+    case TimeZoneOffsetProperty:
+        return TimeZoneOffsetComponent;
+    case TimeZonesProperty:
+        return TimeZonesComponent;
+    case EventsProperty:
+    case EventsShortProperty:
+        return EventsComponent;
+    case HolidaysProperty:
+    case HolidayProperty:
+        return HolidaysComponent;
+    case SunriseProperty:
+        return SunriseComponent;
+    case SunsetProperty:
+        return SunsetComponent;
+    default:
+        return InvalidComponent;
+    }
+
+    return InvalidComponent;
+}
+
+ComponentOptions ClockContext::getPropertyOptions(ContextProperty property)
+{
+    ComponentOptions options;
+
+    switch (property) {
+    case SecondShortProperty:
+    case MinuteShortProperty:
+    case HourShortProperty:
+    case DayOfMonthShortProperty:
+    case MonthShortProperty:
+    case YearShortProperty:
+    case TimeShortProperty:
+    case DateShortProperty:
+    case DateTimeShortProperty:
+    case EventsShortProperty:
+    case HolidayProperty:
+        options.flags = ShortOption;
+
+        break;
+    case Hour12Property:
+        options.alternative = EnabledState;
+
+        break;
+    case Hour24Property:
+        options.alternative = DisabledState;
+
+        break;
+    case DayOfWeekNameProperty:
+    case MonthNameProperty:
+        options.flags = TextOption;
+
+        break;
+    case DayOfWeekShortNameProperty:
+    case MonthShortNameProperty:
+        options.flags = (TextOption | ShortOption);
+
+        break;
+    default:
+        break;
+    }
+
+    return options;
+}
+
+}
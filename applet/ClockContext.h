@@ -0,0 +1,212 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#ifndef ADJUSTABLECLOCKCLOCKCONTEXT_HEADER
+#define ADJUSTABLECLOCKCLOCKCONTEXT_HEADER
+
+#include "DataSource.h"
+
+#include <QtCore/QBitArray>
+#include <QtCore/QStringList>
+
+namespace AdjustableClock
+{
+
+enum ContextProperty
+{
+    SecondProperty = 0,
+    SecondShortProperty = 1,
+    MinuteProperty = 2,
+    MinuteShortProperty = 3,
+    HourProperty = 4,
+    HourShortProperty = 5,
+    Hour12Property = 6,
+    Hour24Property = 7,
+    MillisecondProperty = 8,
+    TimeOfDayProperty = 9,
+    DayOfWeekProperty = 10,
+    DayOfWeekNameProperty = 11,
+    DayOfWeekShortNameProperty = 12,
+    DayOfMonthProperty = 13,
+    DayOfMonthShortProperty = 14,
+    DayOfYearProperty = 15,
+    WeekProperty = 16,
+    MonthProperty = 17,
+    MonthShortProperty = 18,
+    MonthNameProperty = 19,
+    MonthShortNameProperty = 20,
+    YearProperty = 21,
+    YearShortProperty = 22,
+    TimestampProperty = 23,
+    TimeProperty = 24,
+    TimeShortProperty = 25,
+    DateProperty = 26,
+    DateShortProperty = 27,
+    DateTimeProperty = 28,
+    DateTimeShortProperty = 29,
+    TimeZoneNameProperty = 30,
+    TimeZoneAbbreviationProperty = 31,
+    TimeZoneOffsetProperty = 32,
+    TimeZonesProperty = 33,
+    EventsProperty = 34,
+    EventsShortProperty = 35,
+    HolidaysProperty = 36,
+    HolidayProperty = 37,
+    SunriseProperty = 38,
+    SunsetProperty = 39,
+    LastProperty = 40
+};
+
+class Clock;
+
+class ADJUSTABLECLOCK_EXPORT ClockContext : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString second READ getSecond NOTIFY secondChanged)
+    Q_PROPERTY(QString secondShort READ getSecondShort NOTIFY secondChanged)
+    Q_PROPERTY(QString minute READ getMinute NOTIFY minuteChanged)
+    Q_PROPERTY(QString minuteShort READ getMinuteShort NOTIFY minuteChanged)
+    Q_PROPERTY(QString hour READ getHour NOTIFY hourChanged)
+    Q_PROPERTY(QString hourShort READ getHourShort NOTIFY hourChanged)
+    Q_PROPERTY(QString hour12 READ getHour12 NOTIFY hourChanged)
+    Q_PROPERTY(QString hour24 READ getHour24 NOTIFY hourChanged)
+    Q_PROPERTY(QString millisecond READ getMillisecond NOTIFY millisecondChanged)
+    Q_PROPERTY(QString timeOfDay READ getTimeOfDay NOTIFY timeOfDayChanged)
+    Q_PROPERTY(QString dayOfWeek READ getDayOfWeek NOTIFY dayOfWeekChanged)
+    Q_PROPERTY(QString dayOfWeekName READ getDayOfWeekName NOTIFY dayOfWeekChanged)
+    Q_PROPERTY(QString dayOfWeekShortName READ getDayOfWeekShortName NOTIFY dayOfWeekChanged)
+    Q_PROPERTY(QString dayOfMonth READ getDayOfMonth NOTIFY dayOfMonthChanged)
+    Q_PROPERTY(QString dayOfMonthShort READ getDayOfMonthShort NOTIFY dayOfMonthChanged)
+    Q_PROPERTY(QString dayOfYear READ getDayOfYear NOTIFY dayOfYearChanged)
+    Q_PROPERTY(QString week READ getWeek NOTIFY weekChanged)
+    Q_PROPERTY(QString month READ getMonth NOTIFY monthChanged)
+    Q_PROPERTY(QString monthShort READ getMonthShort NOTIFY monthChanged)
+    Q_PROPERTY(QString monthName READ getMonthName NOTIFY monthChanged)
+    Q_PROPERTY(QString monthShortName READ getMonthShortName NOTIFY monthChanged)
+    Q_PROPERTY(QString year READ getYear NOTIFY yearChanged)
+    Q_PROPERTY(QString yearShort READ getYearShort NOTIFY yearChanged)
+    Q_PROPERTY(QString timestamp READ getTimestamp NOTIFY timestampChanged)
+    Q_PROPERTY(QString time READ getTime NOTIFY timeChanged)
+    Q_PROPERTY(QString timeShort READ getTimeShort NOTIFY timeChanged)
+    Q_PROPERTY(QString date READ getDate NOTIFY dateChanged)
+    Q_PROPERTY(QString dateShort READ getDateShort NOTIFY dateChanged)
+    Q_PROPERTY(QString dateTime READ getDateTime NOTIFY dateTimeChanged)
+    Q_PROPERTY(QString dateTimeShort READ getDateTimeShort NOTIFY dateTimeChanged)
+    Q_PROPERTY(QString timeZoneName READ getTimeZoneName NOTIFY timeZoneNameChanged)
+    Q_PROPERTY(QString timeZoneAbbreviation READ getTimeZoneAbbreviation NOTIFY timeZoneAbbreviationChanged)
+    Q_PROPERTY(QString timeZoneOffset READ getTimeZoneOffset NOTIFY timeZoneOffsetChanged)
+    Q_PROPERTY(QString timeZones READ getTimeZones NOTIFY timeZonesChanged)
+    Q_PROPERTY(QString events READ getEvents NOTIFY eventsChanged)
+    Q_PROPERTY(QString eventsShort READ getEventsShort NOTIFY eventsChanged)
+    Q_PROPERTY(QString holidays READ getHolidays NOTIFY holidaysChanged)
+    Q_PROPERTY(QString holiday READ getHoliday NOTIFY holidaysChanged)
+    Q_PROPERTY(QString sunrise READ getSunrise NOTIFY sunriseChanged)
+    Q_PROPERTY(QString sunset READ getSunset NOTIFY sunsetChanged)
+    Q_PROPERTY(QVariantMap options READ getOptions NOTIFY optionsChanged)
+
+    public:
+        explicit ClockContext(Clock *clock, QObject *parent = NULL);
+
+        void updateComponent(ClockComponent component);
+        void updateOptions();
+        QString getSecond() const;
+        QString getSecondShort() const;
+        QString getMinute() const;
+        QString getMinuteShort() const;
+        QString getHour() const;
+        QString getHourShort() const;
+        QString getHour12() const;
+        QString getHour24() const;
+        QString getMillisecond() const;
+        QString getTimeOfDay() const;
+        QString getDayOfWeek() const;
+        QString getDayOfWeekName() const;
+        QString getDayOfWeekShortName() const;
+        QString getDayOfMonth() const;
+        QString getDayOfMonthShort() const;
+        QString getDayOfYear() const;
+        QString getWeek() const;
+        QString getMonth() const;
+        QString getMonthShort() const;
+        QString getMonthName() const;
+        QString getMonthShortName() const;
+        QString getYear() const;
+        QString getYearShort() const;
+        QString getTimestamp() const;
+        QString getTime() const;
+        QString getTimeShort() const;
+        QString getDate() const;
+        QString getDateShort() const;
+        QString getDateTime() const;
+        QString getDateTimeShort() const;
+        QString getTimeZoneName() const;
+        QString getTimeZoneAbbreviation() const;
+        QString getTimeZoneOffset() const;
+        QString getTimeZones() const;
+        QString getEvents() const;
+        QString getEventsShort() const;
+        QString getHolidays() const;
+        QString getHoliday() const;
+        QString getSunrise() const;
+        QString getSunset() const;
+        QVariantMap getOptions() const;
+        static QString getPropertyName(ClockComponent component, const ComponentOptions &options);
+
+    protected:
+        QString getValue(ContextProperty property) const;
+        static ClockComponent getPropertyComponent(ContextProperty property);
+        static ComponentOptions getPropertyOptions(ContextProperty property);
+
+    private:
+        Clock *m_clock;
+        mutable QStringList m_values;
+        mutable QBitArray m_loaded;
+        QVariantMap m_options;
+
+    signals:
+        void secondChanged();
+        void minuteChanged();
+        void hourChanged();
+        void millisecondChanged();
+        void timeOfDayChanged();
+        void dayOfWeekChanged();
+        void dayOfMonthChanged();
+        void dayOfYearChanged();
+        void weekChanged();
+        void monthChanged();
+        void yearChanged();
+        void timestampChanged();
+        void timeChanged();
+        void dateChanged();
+        void dateTimeChanged();
+        void timeZoneNameChanged();
+        void timeZoneAbbreviationChanged();
+        void timeZoneOffsetChanged();
+        void timeZonesChanged();
+        void eventsChanged();
+        void holidaysChanged();
+        void sunriseChanged();
+        void sunsetChanged();
+        void optionsChanged();
+};
+
+}
+
+#endif
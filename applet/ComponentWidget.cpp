@@ -58,14 +58,7 @@ ComponentWidget::ComponentWidget(QWidget *parent, Clock *clock) : QWidget(parent
 
 void ComponentWidget::insertComponent()
 {
-    QStringList options;
-    QVariantMap::iterator iterator;
-
-    for (iterator = m_options.begin(); iterator != m_options.end(); ++iterator) {
-        options.append(QString("'%1': %2").arg(iterator.key()).arg(iterator.value().toString()));
-    }
-
-    emit insertComponent(Clock::getComponentString(m_component), (options.isEmpty() ? QString() : options.join(QString(", "))));
+    emit insertComponent(Clock::getComponentString(m_component), m_options.toString());
 }
 
 void ComponentWidget::addOption(QWidget *widget)
@@ -87,12 +80,14 @@ void ComponentWidget::selectComponent(QAction *action)
 
     m_component = static_cast<ClockComponent>(action->data().toInt());
 
-    m_options.clear();
+    m_options = ComponentOptions();
 
     m_componentUi.componentButton->setText(action->text());
     m_componentUi.optionsButton->menu()->clear();
 
-    if (m_component == SecondComponent || m_component == MinuteComponent || m_component == HourComponent || m_component == DayOfWeekComponent || m_component == DayOfMonthComponent || m_component == DayOfYearComponent || m_component == WeekComponent || m_component == MonthComponent || m_component == YearComponent || m_component == TimeComponent || m_component == DateComponent || m_component == DateTimeComponent || m_component == HolidaysComponent || m_component == EventsComponent) {
+    const int capabilities = Clock::getComponentCapabilities(m_component);
+
+    if (capabilities & ShortFormCapability) {
         QCheckBox *checkBox = new QCheckBox(i18n("Short Form"), m_componentUi.optionsButton->menu());
 
         addOption(checkBox);
@@ -100,7 +95,7 @@ void ComponentWidget::selectComponent(QAction *action)
         connect(checkBox, SIGNAL(toggled(bool)), this, SLOT(setShortForm(bool)));
     }
 
-    if (m_component == HourComponent) {
+    if (capabilities & AlternativeFormCapability) {
         QCheckBox *checkBox = new QCheckBox(i18n("12 Hour Mode"), m_componentUi.optionsButton->menu());
         checkBox->setTristate(true);
         checkBox->setCheckState(Qt::PartiallyChecked);
@@ -110,7 +105,15 @@ void ComponentWidget::selectComponent(QAction *action)
         connect(checkBox, SIGNAL(stateChanged(int)), this, SLOT(setAlternativeForm(int)));
     }
 
-    if (m_component == DayOfWeekComponent || m_component == MonthComponent) {
+    if (capabilities & MillisecondsCapability) {
+        QCheckBox *checkBox = new QCheckBox(i18n("Milliseconds"), m_componentUi.optionsButton->menu());
+
+        addOption(checkBox);
+
+        connect(checkBox, SIGNAL(toggled(bool)), this, SLOT(setMillisecondsForm(bool)));
+    }
+
+    if (capabilities & TextualFormCapability) {
         QCheckBox *checkBox = new QCheckBox(i18n("Textual Form"), m_componentUi.optionsButton->menu());
 
         addOption(checkBox);
@@ -118,7 +121,7 @@ void ComponentWidget::selectComponent(QAction *action)
         connect(checkBox, SIGNAL(toggled(bool)), this, SLOT(setTextualForm(bool)));
     }
 
-    if (m_component == MonthComponent) {
+    if (capabilities & PossessiveFormCapability) {
         QCheckBox *checkBox = new QCheckBox(i18n("Possessive Form"), m_componentUi.optionsButton->menu());
         checkBox->setTristate(true);
         checkBox->setCheckState(Qt::PartiallyChecked);
@@ -144,9 +147,9 @@ void ComponentWidget::updatePreview()
 void ComponentWidget::setShortForm(bool form)
 {
     if (form) {
-        m_options["short"] = true;
-    } else if (m_options.contains("short")) {
-        m_options.remove("short");
+        m_options.flags |= ShortOption;
+    } else {
+        m_options.flags &= ~ShortOption;
     }
 
     updatePreview();
@@ -154,11 +157,7 @@ void ComponentWidget::setShortForm(bool form)
 
 void ComponentWidget::setAlternativeForm(int form)
 {
-    if (form != Qt::PartiallyChecked) {
-        m_options["alternative"] = (form == Qt::Checked);
-    } else if (m_options.contains("alternative")) {
-        m_options.remove("alternative");
-    }
+    m_options.alternative = ((form == Qt::PartiallyChecked) ? DefaultState : ((form == Qt::Checked) ? EnabledState : DisabledState));
 
     updatePreview();
 }
@@ -166,9 +165,9 @@ void ComponentWidget::setAlternativeForm(int form)
 void ComponentWidget::setTextualForm(bool form)
 {
     if (form) {
-        m_options["text"] = true;
-    } else if (m_options.contains("text")) {
-        m_options.remove("text");
+        m_options.flags |= TextOption;
+    } else {
+        m_options.flags &= ~TextOption;
     }
 
     updatePreview();
@@ -176,10 +175,17 @@ void ComponentWidget::setTextualForm(bool form)
 
 void ComponentWidget::setPossessiveForm(int form)
 {
-    if (form != Qt::PartiallyChecked) {
-        m_options["possessive"] = (form == Qt::Checked);
-    } else if (m_options.contains("possessive")) {
-        m_options.remove("possessive");
+    m_options.possessive = ((form == Qt::PartiallyChecked) ? DefaultState : ((form == Qt::Checked) ? EnabledState : DisabledState));
+
+    updatePreview();
+}
+
+void ComponentWidget::setMillisecondsForm(bool form)
+{
+    if (form) {
+        m_options.flags |= MillisecondsOption;
+    } else {
+        m_options.flags &= ~MillisecondsOption;
     }
 
     updatePreview();
@@ -52,10 +52,11 @@ class ComponentWidget : public QWidget
         void setAlternativeForm(int form);
         void setTextualForm(bool form);
         void setPossessiveForm(int form);
+        void setMillisecondsForm(bool form);
 
     private:
         Clock *m_clock;
-        QVariantMap m_options;
+        ComponentOptions m_options;
         ClockComponent m_component;
         Ui::component m_componentUi;
 
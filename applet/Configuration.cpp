@@ -25,6 +25,7 @@
 #include "OptionWidget.h"
 #include "ThemeDelegate.h"
 #include "ExpressionDelegate.h"
+#include "ThemeIndex.h"
 
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
@@ -60,14 +61,10 @@ Configuration::Configuration(Applet *applet, Clock *clock, KConfigDialog *parent
 
     m_clock->setParent(this);
 
-    const QStringList locations = KGlobal::dirs()->findDirs("data", "plasma/adjustableclock");
+    const QList<ThemeInfo> themes = ThemeIndex::getInstance()->getThemes();
 
-    for (int i = 0; i < locations.count(); ++i) {
-        const QStringList themes = Plasma::Package::listInstalled(locations.at(i));
-
-        for (int j = 0; j < themes.count(); ++j) {
-            loadTheme(locations.at(i) + QDir::separator() + themes.at(j));
-        }
+    for (int i = 0; i < themes.count(); ++i) {
+        loadTheme(themes.at(i));
     }
 
     m_themesModel->setSortRole(SortRole);
@@ -101,7 +98,7 @@ Configuration::Configuration(Applet *applet, Clock *clock, KConfigDialog *parent
     m_clipboardUi.actionsView->setModel(m_actionsModel);
     m_clipboardUi.actionsView->setItemDelegate(new ExpressionDelegate(m_clock));
     m_clipboardUi.actionsView->viewport()->installEventFilter(this);
-    m_clipboardUi.fastCopyExpressionEdit->setText(m_applet->config().readEntry("fastCopyExpression", "Clock.getValue(Clock.Year) + '-' + Clock.getValue(Clock.Month) + '-' + Clock.getValue(Clock.DayOfMonth) + ' ' + Clock.getValue(Clock.Hour) + ':' + Clock.getValue(Clock.Minute) + ':' + Clock.getValue(Clock.Second)"));
+    m_clipboardUi.fastCopyExpressionEdit->setText(m_applet->config().readEntry("fastCopyExpression", "%{Year}-%{Month}-%{DayOfMonth} %{Hour}:%{Minute}:%{Second}"));
     m_clipboardUi.fastCopyExpressionEdit->setClock(m_clock);
 
     parent->addPage(appearanceConfiguration, i18n("Appearance"), "preferences-desktop-theme");
@@ -190,11 +187,13 @@ void Configuration::installTheme()
     const QString path = KStandardDirs::locateLocal("data", "plasma/adjustableclock");
 
     if (Plasma::Package::installPackage(installDialog.selectedFile(), path, QString())) {
-        const QStringList themes = Plasma::Package::listInstalled(path);
+        ThemeIndex::getInstance()->update();
+
+        const QList<ThemeInfo> themes = ThemeIndex::getInstance()->getThemes();
 
         for (int i = 0; i < themes.count(); ++i) {
-            if (findRow(themes.at(i), IdentifierRole) < 0) {
-                loadTheme(path + QDir::separator() + themes.at(i));
+            if (findRow(themes.at(i).identifier, IdentifierRole) < 0) {
+                loadTheme(themes.at(i));
 
                 const QModelIndex index = m_themesModel->index((m_themesModel->rowCount() - 1), 0);
 
@@ -500,7 +499,7 @@ void Configuration::showContextMenu(const QPoint &position)
         menu.addSeparator();
     }
 
-    if (QFile::exists(index.data(PathRole).toString() + "/contents/config/main.xml")) {
+    if (index.data(ConfigurableRole).toBool()) {
         menu.addAction(KIcon("configure"), i18n("Options..."), this, SLOT(configureTheme()));
     }
 
@@ -682,17 +681,17 @@ bool Configuration::copyTheme(QStandardItem *item)
     return true;
 }
 
-bool Configuration::loadTheme(const QString &path)
+bool Configuration::loadTheme(const ThemeInfo &theme)
 {
-    Plasma::PackageMetadata metaData(path + "/metadata.desktop");
     QStandardItem *item = new QStandardItem();
-    item->setData(QFileInfo(path).fileName(), IdentifierRole);
-    item->setData(QFileInfo(path).canonicalFilePath(), PathRole);
-    item->setData(metaData.name().toLower(), SortRole);
-    item->setData(metaData.name(), NameRole);
-    item->setData(metaData.description(), DescriptionRole);
-    item->setData(!metaData.author().isEmpty(), AboutRole);
-    item->setData(QFileInfo(path).isWritable(), EditableRole);
+    item->setData(theme.identifier, IdentifierRole);
+    item->setData(theme.path, PathRole);
+    item->setData(theme.name.toLower(), SortRole);
+    item->setData(theme.name, NameRole);
+    item->setData(theme.description, DescriptionRole);
+    item->setData(!theme.author.isEmpty(), AboutRole);
+    item->setData(theme.editable, EditableRole);
+    item->setData(theme.configuration, ConfigurableRole);
 
     m_themesModel->appendRow(item);
 
@@ -763,3 +762,15 @@ bool Configuration::eventFilter(QObject *object, QEvent *event)
 }
 
 }
+
+extern "C"
+{
+    KDE_EXPORT void adjustableclock_configuration(AdjustableClock::Applet *applet, AdjustableClock::Clock *clock, KConfigDialog *parent)
+    {
+        const AdjustableClock::ConfigurationFactory factory = &adjustableclock_configuration;
+
+        Q_UNUSED(factory)
+
+        new AdjustableClock::Configuration(applet, clock, parent);
+    }
+}
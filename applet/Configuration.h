@@ -42,12 +42,15 @@ enum ModelRole
     NameRole,
     DescriptionRole,
     AboutRole,
-    EditableRole
+    EditableRole,
+    ConfigurableRole
 };
 
 class Applet;
 class Clock;
 
+struct ThemeInfo;
+
 class Configuration : public QObject
 {
     Q_OBJECT
@@ -61,7 +64,7 @@ class Configuration : public QObject
         QString createIdentifier(const QString &base = QString()) const;
         Plasma::PackageMetadata getMetaData(const QString &path) const;
         int findRow(const QString &text, int role = NameRole) const;
-        bool loadTheme(const QString &path);
+        bool loadTheme(const ThemeInfo &theme);
         bool saveTheme(const QString &path, Plasma::PackageMetadata metaData);
         static bool copyDirectory(const QString &source, const QString &destination);
 
@@ -0,0 +1,267 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#include "DataHub.h"
+
+#include <KDateTime>
+#include <KLocale>
+#include <KGlobal>
+#include <KSystemTimeZones>
+
+namespace AdjustableClock
+{
+
+QHash<QString, DataHub*> DataHub::m_hubs;
+
+DataHub::DataHub(Plasma::DataEngine *timeEngine, const QString &timeZone, const QString &holidaysRegion) : QObject(),
+    m_timeEngine(timeEngine),
+    m_key(timeZone + QLatin1Char('|') + holidaysRegion),
+    m_timeZone(timeZone),
+    m_holidaysRegion(holidaysRegion),
+    m_references(0)
+{
+    for (int i = 0; i < LastFeature; ++i) {
+        m_features[i] = 0;
+    }
+
+    const Plasma::DataEngine::Data data = m_timeEngine->query(m_timeZone);
+
+    m_dateTime = QDateTime(data["Date"].toDate(), data["Time"].toTime());
+
+    m_tickTimer.start();
+
+    m_timeEngine->connectSource(m_timeZone, this, 1000, Plasma::NoAlignment);
+}
+
+DataHub::~DataHub()
+{
+    if (m_timeEngine) {
+        m_timeEngine->disconnectSource(m_timeZone, this);
+    }
+
+    if (m_calendarEngine && !m_eventsQuery.isEmpty()) {
+        m_calendarEngine->disconnectSource(m_eventsQuery, this);
+    }
+}
+
+DataHub* DataHub::acquire(Plasma::DataEngine *timeEngine, const QString &timeZone, const QString &holidaysRegion)
+{
+    const QString key = (timeZone + QLatin1Char('|') + holidaysRegion);
+    DataHub *hub = m_hubs.value(key, NULL);
+
+    if (!hub) {
+        hub = new DataHub(timeEngine, timeZone, holidaysRegion);
+
+        m_hubs[key] = hub;
+    }
+
+    ++hub->m_references;
+
+    return hub;
+}
+
+void DataHub::release(DataHub *hub)
+{
+    if (!hub || --hub->m_references > 0) {
+        return;
+    }
+
+    m_hubs.remove(hub->m_key);
+
+    delete hub;
+}
+
+void DataHub::addFeature(DataFeature feature, Plasma::DataEngine *calendarEngine)
+{
+    if (calendarEngine && !m_calendarEngine) {
+        m_calendarEngine = calendarEngine;
+    }
+
+    if (++m_features[feature] == 1) {
+        updateFeature(feature);
+    }
+}
+
+void DataHub::removeFeature(DataFeature feature)
+{
+    if (m_features[feature] == 0 || --m_features[feature] > 0) {
+        return;
+    }
+
+    switch (feature) {
+    case EventsFeature:
+        if (m_calendarEngine) {
+            m_calendarEngine->disconnectSource(m_eventsQuery, this);
+        }
+
+        m_eventsQuery.clear();
+        m_events.clear();
+
+        break;
+    case HolidaysFeature:
+        m_holidays.clear();
+
+        break;
+    case SolarFeature:
+        m_sunrise = QTime();
+        m_sunset = QTime();
+
+        break;
+    default:
+        break;
+    }
+}
+
+void DataHub::updateFeature(DataFeature feature)
+{
+    if (feature == EventsFeature) {
+        if (!m_calendarEngine) {
+            return;
+        }
+
+        if (!m_eventsQuery.isEmpty()) {
+            m_calendarEngine->disconnectSource(m_eventsQuery, this);
+        }
+
+        m_eventsQuery = QString("events:%1:%2").arg(m_dateTime.date().toString(Qt::ISODate)).arg(m_dateTime.date().addDays(1).toString(Qt::ISODate));
+
+        m_calendarEngine->connectSource(m_eventsQuery, this);
+    } else if (feature == HolidaysFeature) {
+        m_holidays.clear();
+
+        if (!m_calendarEngine) {
+            return;
+        }
+
+        const QString region = (m_holidaysRegion.isEmpty() ? m_calendarEngine->query("holidaysDefaultRegion")["holidaysDefaultRegion"].toString() : m_holidaysRegion);
+        const QString key = QString("holidays:%1:%2").arg(region).arg(m_dateTime.date().toString(Qt::ISODate));
+        const Plasma::DataEngine::Data holidaysData = m_calendarEngine->query(key);
+
+        if (!holidaysData.isEmpty() && holidaysData.contains(key)) {
+            const QVariantList holidays = holidaysData[key].toList();
+
+            for (int i = 0; i < holidays.length(); ++i) {
+                m_holidays.append(holidays[i].toHash()["Name"].toString());
+            }
+        }
+    } else if (feature == SolarFeature && m_timeEngine) {
+        const KTimeZone timeZone = KSystemTimeZones::zone(m_timeZone);
+        const Plasma::DataEngine::Data sunData = m_timeEngine->query((timeZone.latitude() == KTimeZone::UNKNOWN) ? QString("%1|Solar").arg(m_timeZone) : QString("%1|Solar|Latitude=%2|Longitude=%3").arg(m_timeZone).arg(timeZone.latitude()).arg(timeZone.longitude()));
+
+        m_sunrise = sunData["Sunrise"].toDateTime().time();
+        m_sunset = sunData["Sunset"].toDateTime().time();
+    }
+}
+
+void DataHub::dataUpdated(const QString &source, const Plasma::DataEngine::Data &data)
+{
+    if (source == m_eventsQuery) {
+        updateEvents(data);
+
+        return;
+    }
+
+    const QDateTime previous = m_dateTime;
+
+    m_dateTime = QDateTime(data["Date"].toDate(), data["Time"].toTime());
+
+    m_tickTimer.start();
+
+    if (m_dateTime.date() != previous.date()) {
+        for (int i = 0; i < LastFeature; ++i) {
+            if (m_features[i] > 0) {
+                updateFeature(static_cast<DataFeature>(i));
+            }
+        }
+    }
+
+    emit updated();
+}
+
+void DataHub::updateEvents(const Plasma::DataEngine::Data &data)
+{
+    m_events.clear();
+
+    QHash<QString, QVariant>::const_iterator iterator;
+    const QPair<QDateTime, QDateTime> limits = qMakePair(QDateTime::currentDateTime().addSecs(-43200), QDateTime::currentDateTime().addSecs(43200));
+
+    for (iterator = data.constBegin(); iterator != data.constEnd(); ++iterator) {
+        const QVariantHash eventData = iterator.value().toHash();
+
+        if (eventData["Type"] == "Event" || eventData["Type"] == "Todo") {
+            const KDateTime startTime = eventData["StartDate"].value<KDateTime>();
+            const KDateTime endTime = eventData["EndDate"].value<KDateTime>();
+
+            if ((endTime.isValid() && endTime.dateTime() < limits.first && endTime != startTime) || startTime.dateTime() > limits.second) {
+                continue;
+            }
+
+            Event event;
+            event.type = ((eventData["Type"] == "Event") ? i18n("Event") : i18n("To do"));
+            event.summary = eventData["Summary"].toString();
+
+            if (startTime.time().hour() == 0 && startTime.time().minute() == 0 && endTime.time().hour() == 0 && endTime.time().minute() == 0) {
+                event.time = i18n("All day");
+            } else if (startTime.isValid()) {
+                event.time = KGlobal::locale()->formatTime(startTime.time(), false);
+
+                if (endTime.isValid()) {
+                    event.time.append(QString(" - %1").arg(KGlobal::locale()->formatTime(endTime.time(), false)));
+                }
+            }
+
+            m_events.append(event);
+        }
+    }
+
+    emit componentChanged(EventsComponent);
+}
+
+QDateTime DataHub::getDateTime() const
+{
+    return m_dateTime;
+}
+
+QTime DataHub::getSunrise() const
+{
+    return m_sunrise;
+}
+
+QTime DataHub::getSunset() const
+{
+    return m_sunset;
+}
+
+QStringList DataHub::getHolidays() const
+{
+    return m_holidays;
+}
+
+QList<Event> DataHub::getEvents() const
+{
+    return m_events;
+}
+
+int DataHub::getElapsed() const
+{
+    return (m_tickTimer.isValid() ? static_cast<int>(m_tickTimer.elapsed()) : -1);
+}
+
+}
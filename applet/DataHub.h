@@ -0,0 +1,90 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#ifndef ADJUSTABLECLOCKDATAHUB_HEADER
+#define ADJUSTABLECLOCKDATAHUB_HEADER
+
+#include "DataSource.h"
+
+#include <QtCore/QPointer>
+
+namespace AdjustableClock
+{
+
+enum DataFeature
+{
+    EventsFeature = 0,
+    HolidaysFeature = 1,
+    SolarFeature = 2,
+    LastFeature = 3
+};
+
+class DataHub : public QObject
+{
+    Q_OBJECT
+
+    public:
+        static DataHub* acquire(Plasma::DataEngine *timeEngine, const QString &timeZone, const QString &holidaysRegion);
+        static void release(DataHub *hub);
+        void addFeature(DataFeature feature, Plasma::DataEngine *calendarEngine = NULL);
+        void removeFeature(DataFeature feature);
+        QDateTime getDateTime() const;
+        QTime getSunrise() const;
+        QTime getSunset() const;
+        QStringList getHolidays() const;
+        QList<Event> getEvents() const;
+        int getElapsed() const;
+
+    protected:
+        DataHub(Plasma::DataEngine *timeEngine, const QString &timeZone, const QString &holidaysRegion);
+        ~DataHub();
+
+        void updateFeature(DataFeature feature);
+        void updateEvents(const Plasma::DataEngine::Data &data);
+
+    protected slots:
+        void dataUpdated(const QString &source, const Plasma::DataEngine::Data &data);
+
+    private:
+        QPointer<Plasma::DataEngine> m_timeEngine;
+        QPointer<Plasma::DataEngine> m_calendarEngine;
+        QElapsedTimer m_tickTimer;
+        QDateTime m_dateTime;
+        QTime m_sunrise;
+        QTime m_sunset;
+        QString m_key;
+        QString m_timeZone;
+        QString m_holidaysRegion;
+        QString m_eventsQuery;
+        QStringList m_holidays;
+        QList<Event> m_events;
+        int m_features[LastFeature];
+        int m_references;
+
+        static QHash<QString, DataHub*> m_hubs;
+
+    signals:
+        void componentChanged(ClockComponent component);
+        void updated();
+};
+
+}
+
+#endif
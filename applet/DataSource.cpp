@@ -19,157 +19,273 @@
 ***********************************************************************************/
 
 #include "Clock.h"
+#include "DataHub.h"
 #include "Applet.h"
 
-#include <KDateTime>
+#include <QtCore/QTimer>
+
 #include <KCalendarSystem>
 #include <KSystemTimeZones>
 
 namespace AdjustableClock
 {
 
-DataSource::DataSource(Applet *applet) : QObject(applet),
-    m_applet(applet)
+ComponentOptions::ComponentOptions(int flags, OptionState alternative, OptionState possessive) :
+    flags(flags),
+    alternative(alternative),
+    possessive(possessive)
 {
-    m_constantDateTime = QDateTime(QDate(2000, 1, 1), QTime(12, 30, 15));
+}
 
-    m_eventsQuery = QString("events:%1:%2").arg(QDate::currentDate().toString(Qt::ISODate)).arg(QDate::currentDate().addDays(1).toString(Qt::ISODate));
+bool ComponentOptions::testFlag(ComponentOption option) const
+{
+    return (flags & option);
+}
 
-    m_applet->dataEngine("calendar")->connectSource(m_eventsQuery, this);
+int ComponentOptions::getKey() const
+{
+    return (flags | (alternative << 3) | (possessive << 5));
+}
 
-    updateTimeZone();
+int ComponentOptions::getCount() const
+{
+    return (testFlag(ShortOption) + testFlag(TextOption) + testFlag(MillisecondsOption) + (alternative != DefaultState) + (possessive != DefaultState));
 }
 
-void DataSource::dataUpdated(const QString &source, const Plasma::DataEngine::Data &data, bool reload)
+QString ComponentOptions::toString() const
 {
-    if (source == m_eventsQuery) {
-        m_events.clear();
+    QStringList options;
 
-        if (data.isEmpty()) {
-            emit componentChanged(EventsComponent);
+    if (testFlag(ShortOption)) {
+        options.append(QLatin1String("'short': true"));
+    }
 
-            return;
-        }
+    if (testFlag(TextOption)) {
+        options.append(QLatin1String("'text': true"));
+    }
 
-        QHash<QString, QVariant>::const_iterator iterator;
-        const QPair<QDateTime, QDateTime> limits = qMakePair(QDateTime::currentDateTime().addSecs(-43200), QDateTime::currentDateTime().addSecs(43200));
+    if (testFlag(MillisecondsOption)) {
+        options.append(QLatin1String("'milliseconds': true"));
+    }
 
-        for (iterator = data.constBegin(); iterator != data.constEnd(); ++iterator) {
-            const QVariantHash eventData = iterator.value().toHash();
+    if (alternative != DefaultState) {
+        options.append(QString("'alternative': %1").arg((alternative == EnabledState) ? "true" : "false"));
+    }
 
-            if (eventData["Type"] == "Event" || eventData["Type"] == "Todo") {
-                const KDateTime startTime = eventData["StartDate"].value<KDateTime>();
-                const KDateTime endTime = eventData["EndDate"].value<KDateTime>();
+    if (possessive != DefaultState) {
+        options.append(QString("'possessive': %1").arg((possessive == EnabledState) ? "true" : "false"));
+    }
 
-                if ((endTime.isValid() && endTime.dateTime() < limits.first && endTime != startTime) || startTime.dateTime() > limits.second) {
-                    continue;
-                }
+    return options.join(QLatin1String(", "));
+}
 
-                Event event;
-                event.type = ((eventData["Type"] == "Event") ? i18n("Event") : i18n("To do"));
-                event.summary = eventData["Summary"].toString();
+QVariantMap ComponentOptions::toMap() const
+{
+    QVariantMap map;
 
-                if (startTime.time().hour() == 0 && startTime.time().minute() == 0 && endTime.time().hour() == 0 && endTime.time().minute() == 0) {
-                    event.time = i18n("All day");
-                } else if (startTime.isValid()) {
-                    event.time = KGlobal::locale()->formatTime(startTime.time(), false);
+    if (testFlag(ShortOption)) {
+        map["short"] = true;
+    }
 
-                    if (endTime.isValid()) {
-                        event.time.append(QString(" - %1").arg(KGlobal::locale()->formatTime(endTime.time(), false)));
-                    }
-                }
+    if (testFlag(TextOption)) {
+        map["text"] = true;
+    }
 
-                m_events.append(event);
-            }
-        }
+    if (testFlag(MillisecondsOption)) {
+        map["milliseconds"] = true;
+    }
 
-        emit componentChanged(EventsComponent);
+    if (alternative != DefaultState) {
+        map["alternative"] = (alternative == EnabledState);
+    }
 
-        return;
+    if (possessive != DefaultState) {
+        map["possessive"] = (possessive == EnabledState);
     }
 
-/*    if (source == m_weatherQuery && !m_weatherQuery.isEmpty()) {
-        return;
-    }*/
+    return map;
+}
 
-    const QDateTime previous = m_dateTime;
+bool ComponentOptions::operator==(const ComponentOptions &other) const
+{
+    return (getKey() == other.getKey());
+}
 
-    m_dateTime = QDateTime(data["Date"].toDate(), data["Time"].toTime());
+ComponentOptions ComponentOptions::fromMap(const QVariantMap &map)
+{
+    ComponentOptions options;
 
-    emit tick();
-    emit componentChanged(SecondComponent);
-    emit componentChanged(TimestampComponent);
-    emit componentChanged(TimeComponent);
-    emit componentChanged(DateTimeComponent);
+    if (map.contains("short")) {
+        options.flags |= ShortOption;
+    }
 
-    if (reload || m_dateTime.time().minute() != previous.time().minute()) {
-        emit componentChanged(MinuteComponent);
+    if (map.contains("text")) {
+        options.flags |= TextOption;
     }
 
-    if (reload || m_dateTime.time().hour() != previous.time().hour()) {
-        emit componentChanged(HourComponent);
+    if (map.contains("milliseconds")) {
+        options.flags |= MillisecondsOption;
+    }
 
-        if (reload || m_dateTime.toString("ap") != previous.toString("ap")) {
-            emit componentChanged(TimeOfDayComponent);
-        }
+    if (map.contains("alternative")) {
+        options.alternative = (map["alternative"].toBool() ? EnabledState : DisabledState);
     }
 
-    if (reload || m_dateTime.date() != previous.date()) {
-        if (reload || m_applet->calendar()->month(m_dateTime.date()) != m_applet->calendar()->month(previous.date())) {
-            if (reload || m_applet->calendar()->year(m_dateTime.date()) != m_applet->calendar()->year(previous.date())) {
-                emit componentChanged(YearComponent);
-            }
+    if (map.contains("possessive")) {
+        options.possessive = (map["possessive"].toBool() ? EnabledState : DisabledState);
+    }
 
-            emit componentChanged(MonthComponent);
-        }
+    return options;
+}
 
-        m_applet->dataEngine("calendar")->disconnectSource(m_eventsQuery, this);
+ComponentOptions ComponentOptions::fromString(const QString &options)
+{
+    QVariantMap map;
+    QRegExp expression("['\"]?(\\w+)['\"]?\\s*:\\s*(true|false|-?\\d+|'[^']*'|\"[^\"]*\")");
+    int position = 0;
 
-        m_eventsQuery = QString("evens:%1:%2").arg(QDate::currentDate().toString(Qt::ISODate)).arg(QDate::currentDate().addDays(1).toString(Qt::ISODate));
+    while ((position = expression.indexIn(options, position)) >= 0) {
+        const QString value = expression.cap(2);
 
-        m_applet->dataEngine("calendar")->connectSource(m_eventsQuery, this);
+        map[expression.cap(1)] = ((value == "true" || value == "false") ? QVariant(value == "true") : QVariant(value));
 
-        const KTimeZone timeZone = KSystemTimeZones::zone(m_applet->isLocalTimezone() ? KSystemTimeZones::local().name() : m_applet->currentTimezone());
-        const Plasma::DataEngine::Data sunData = m_applet->dataEngine("time")->query((timeZone.latitude() == KTimeZone::UNKNOWN) ? QString("%1|Solar").arg(m_applet->currentTimezone()) : QString("%1|Solar|Latitude=%2|Longitude=%3").arg(m_applet->currentTimezone()).arg(timeZone.latitude()).arg(timeZone.longitude()));
+        position += expression.matchedLength();
+    }
 
-        m_sunrise = sunData["Sunrise"].toDateTime().time();
-        m_sunset = sunData["Sunset"].toDateTime().time();
+    return fromMap(map);
+}
 
-        const QString key = QString("holidays:%1:%2").arg(m_applet->config().readEntry("holidaysRegions", m_applet->dataEngine("calendar")->query("holidaysDefaultRegion")["holidaysDefaultRegion"]).toString().split(QChar(',')).first()).arg(m_dateTime.date().toString(Qt::ISODate));
-        const Plasma::DataEngine::Data holidaysData = m_applet->dataEngine("calendar")->query(key);
+DataSource::DataSource(Applet *applet) : QObject(applet),
+    m_applet(applet),
+    m_hub(NULL),
+    m_features(0),
+    m_staleFeatures(0),
+    m_timeZoneSeconds(0),
+    m_prediction(false),
+    m_resetPending(false)
+{
+    m_constantDateTime = QDateTime(QDate(2000, 1, 1), QTime(12, 30, 15));
 
-        m_holidays.clear();
+    updateTimeZone();
+}
 
-        if (!holidaysData.isEmpty() && holidaysData.contains(key)) {
-            const QVariantList holidays = holidaysData[key].toList();
+DataSource::~DataSource()
+{
+    releaseFeatures();
 
-            for (int i = 0; i < holidays.length(); ++i) {
-                m_holidays.append(holidays[i].toHash()["Name"].toString());
-            }
-        }
+    DataHub::release(m_hub);
+}
+
+void DataSource::updateTime(bool reload)
+{
+    const QDateTime previous = m_dateTime;
 
-        emit componentChanged(DayOfWeekComponent);
-        emit componentChanged(DayOfMonthComponent);
-        emit componentChanged(DayOfYearComponent);
-        emit componentChanged(WeekComponent);
-        emit componentChanged(DateComponent);
+    m_dateTime = m_hub->getDateTime();
+
+    emit tick();
+
+    const QList<ClockComponent> components = getChangedComponents(previous, m_dateTime, reload);
+
+    for (int i = 0; i < components.count(); ++i) {
+        emit componentChanged(components.at(i));
+    }
+
+    if (reload) {
+        emit componentChanged(EventsComponent);
+    }
+
+    if (reload || m_dateTime.date() != previous.date()) {
         emit componentChanged(SunriseComponent);
         emit componentChanged(SunsetComponent);
         emit componentChanged(HolidaysComponent);
     }
 }
 
+void DataSource::requireFeature(int feature) const
+{
+    m_staleFeatures &= ~(1 << feature);
+
+    if (m_features & (1 << feature)) {
+        return;
+    }
+
+    m_features |= (1 << feature);
+
+    m_hub->addFeature(static_cast<DataFeature>(feature), ((feature == SolarFeature) ? NULL : m_applet->dataEngine("calendar")));
+}
+
+void DataSource::releaseFeatures()
+{
+    if (!m_hub) {
+        return;
+    }
+
+    for (int i = 0; i < LastFeature; ++i) {
+        if (m_features & (1 << i)) {
+            m_hub->removeFeature(static_cast<DataFeature>(i));
+        }
+    }
+
+    m_features = 0;
+    m_staleFeatures = 0;
+}
+
+void DataSource::resetFeatures()
+{
+    if (m_resetPending || !m_features) {
+        return;
+    }
+
+    m_resetPending = true;
+    m_staleFeatures = m_features;
+
+    QTimer::singleShot(0, this, SLOT(releaseStaleFeatures()));
+
+    emit componentChanged(EventsComponent);
+    emit componentChanged(SunriseComponent);
+    emit componentChanged(SunsetComponent);
+    emit componentChanged(HolidaysComponent);
+}
+
+void DataSource::releaseStaleFeatures()
+{
+    m_resetPending = false;
+
+    for (int i = 0; i < LastFeature; ++i) {
+        if (m_staleFeatures & m_features & (1 << i)) {
+            m_hub->removeFeature(static_cast<DataFeature>(i));
+
+            m_features &= ~(1 << i);
+        }
+    }
+
+    m_staleFeatures = 0;
+}
+
+void DataSource::setPrediction(bool enabled)
+{
+    m_prediction = enabled;
+}
+
 void DataSource::updateTimeZone()
 {
     const QString currentTimeZone = (m_applet->isLocalTimezone() ? KSystemTimeZones::local().name() : m_applet->currentTimezone());
 
-    if (!m_timeQuery.isEmpty()) {
-        m_applet->dataEngine("time")->disconnectSource(m_timeQuery, this);
+    const QString holidaysRegion = m_applet->config().readEntry("holidaysRegions", QString()).split(QChar(',')).first();
+    DataHub *hub = DataHub::acquire(m_applet->dataEngine("time"), currentTimeZone, holidaysRegion);
+
+    if (m_hub) {
+        releaseFeatures();
+
+        disconnect(m_hub, 0, this, 0);
+
+        DataHub::release(m_hub);
     }
 
-    m_timeQuery = currentTimeZone;
+    m_hub = hub;
 
-    m_applet->dataEngine("time")->connectSource(m_timeQuery, this, 1000, Plasma::NoAlignment);
+    connect(m_hub, SIGNAL(updated()), this, SLOT(updateTime()));
+    connect(m_hub, SIGNAL(componentChanged(ClockComponent)), this, SIGNAL(componentChanged(ClockComponent)));
 
     QStringList timeZones = m_applet->config().readEntry("timeZones", QStringList());
 
@@ -194,6 +310,9 @@ void DataSource::updateTimeZone()
             }
 
             const int seconds = timeZone.currentOffset(Qt::UTC);
+
+            m_timeZoneSeconds = seconds;
+
             const int hours = abs(seconds / 3600);
             const int minutes = (abs(seconds / 60) - (hours * 60));
 
@@ -210,7 +329,55 @@ void DataSource::updateTimeZone()
     emit componentChanged(TimeZoneAbbreviationComponent);
     emit componentChanged(TimeZoneOffsetComponent);
 
-    dataUpdated(QString(), m_applet->dataEngine("time")->query(m_applet->currentTimezone()), true);
+    updateTime(true);
+}
+
+QList<ClockComponent> DataSource::getChangedComponents(const QDateTime &previous, const QDateTime &current, bool reload) const
+{
+    QList<ClockComponent> components;
+    components << SecondComponent << TimestampComponent << TimeComponent << DateTimeComponent;
+
+    if (reload || current.time().minute() != previous.time().minute()) {
+        components << MinuteComponent;
+    }
+
+    if (reload || current.time().hour() != previous.time().hour()) {
+        components << HourComponent;
+
+        if (reload || current.toString("ap") != previous.toString("ap")) {
+            components << TimeOfDayComponent;
+        }
+    }
+
+    if (reload || current.date() != previous.date()) {
+        if (reload || m_applet->calendar()->month(current.date()) != m_applet->calendar()->month(previous.date())) {
+            if (reload || m_applet->calendar()->year(current.date()) != m_applet->calendar()->year(previous.date())) {
+                components << YearComponent;
+            }
+
+            components << MonthComponent;
+        }
+
+        components << DayOfWeekComponent << DayOfMonthComponent << DayOfYearComponent << WeekComponent << DateComponent;
+    }
+
+    return components;
+}
+
+QList<ClockComponent> DataSource::getPredictedComponents() const
+{
+    const QDateTime next = m_dateTime.addSecs(1);
+
+    if (!m_dateTime.isValid() || next.date() != m_dateTime.date()) {
+        return QList<ClockComponent>();
+    }
+
+    return getChangedComponents(m_dateTime, next);
+}
+
+QDateTime DataSource::getDateTime() const
+{
+    return m_dateTime;
 }
 
 QString DataSource::formatNumber(int number, int length)
@@ -223,49 +390,72 @@ QVariant DataSource::getOption(const QString &key, const QVariant &defaultValue,
     return m_applet->config().group("theme-" + (theme.isEmpty() ? m_applet->config().readEntry("theme", "digital") : theme)).readEntry(key, defaultValue);
 }
 
-QVariant DataSource::getValue(ClockComponent component, const QVariantMap &options, bool constant) const
+QVariantMap DataSource::getOptions(const QString &theme) const
+{
+    const QMap<QString, QString> entries = m_applet->config().group("theme-" + (theme.isEmpty() ? m_applet->config().readEntry("theme", "digital") : theme)).entryMap();
+    QMap<QString, QString>::const_iterator iterator;
+    QVariantMap options;
+
+    for (iterator = entries.constBegin(); iterator != entries.constEnd(); ++iterator) {
+        options[iterator.key()] = iterator.value();
+    }
+
+    return options;
+}
+
+QVariant DataSource::getValue(ClockComponent component, const ComponentOptions &options, bool constant) const
 {
-    const QDateTime dateTime = (constant ? m_constantDateTime : m_dateTime);
+    const QDateTime dateTime = (constant ? m_constantDateTime : (m_prediction ? m_dateTime.addSecs(1) : m_dateTime));
 
     switch (component) {
     case SecondComponent:
-        return formatNumber(dateTime.time().second(), (options.contains("short") ? 0 : 2));
+        return formatNumber(dateTime.time().second(), (options.testFlag(ShortOption) ? 0 : 2));
     case MinuteComponent:
-        return formatNumber(dateTime.time().minute(), (options.contains("short") ? 0 : 2));
+        return formatNumber(dateTime.time().minute(), (options.testFlag(ShortOption) ? 0 : 2));
     case HourComponent:
-        return formatNumber(((options.contains("alternative") ? options["alternative"].toBool() : KGlobal::locale()->use12Clock()) ? (((dateTime.time().hour() + 11) % 12) + 1) : dateTime.time().hour()), (options.contains("short") ? 0 : 2));
+        return formatNumber((((options.alternative != DefaultState) ? (options.alternative == EnabledState) : KGlobal::locale()->use12Clock()) ? (((dateTime.time().hour() + 11) % 12) + 1) : dateTime.time().hour()), (options.testFlag(ShortOption) ? 0 : 2));
     case TimeOfDayComponent:
         return ((dateTime.time().hour() >= 12) ? i18n("pm") : i18n("am"));
     case DayOfMonthComponent:
-        return formatNumber(m_applet->calendar()->day(dateTime.date()), (options.contains("short") ? 0 : 2));
+        return formatNumber(m_applet->calendar()->day(dateTime.date()), (options.testFlag(ShortOption) ? 0 : 2));
     case DayOfWeekComponent:
-        if (options.contains("text")) {
-            return m_applet->calendar()->weekDayName(m_applet->calendar()->dayOfWeek(dateTime.date()), (options.contains("short") ? KCalendarSystem::ShortDayName : KCalendarSystem::LongDayName));
+        if (options.testFlag(TextOption)) {
+            return m_applet->calendar()->weekDayName(m_applet->calendar()->dayOfWeek(dateTime.date()), (options.testFlag(ShortOption) ? KCalendarSystem::ShortDayName : KCalendarSystem::LongDayName));
         }
 
-        return formatNumber(m_applet->calendar()->dayOfWeek(dateTime.date()), (options.contains("short") ? 0 : QString::number(m_applet->calendar()->daysInWeek(dateTime.date())).length()));
+        return formatNumber(m_applet->calendar()->dayOfWeek(dateTime.date()), (options.testFlag(ShortOption) ? 0 : QString::number(m_applet->calendar()->daysInWeek(dateTime.date())).length()));
     case DayOfYearComponent:
-        return formatNumber(m_applet->calendar()->dayOfYear(dateTime.date()), (options.contains("short") ? 0 : QString::number(m_applet->calendar()->daysInYear(dateTime.date())).length()));
+        return formatNumber(m_applet->calendar()->dayOfYear(dateTime.date()), (options.testFlag(ShortOption) ? 0 : QString::number(m_applet->calendar()->daysInYear(dateTime.date())).length()));
     case WeekComponent:
-        return m_applet->calendar()->formatDate(dateTime.date(), KLocale::Week, (options.contains("short") ? KLocale::ShortNumber : KLocale::LongNumber));
+        return m_applet->calendar()->formatDate(dateTime.date(), KLocale::Week, (options.testFlag(ShortOption) ? KLocale::ShortNumber : KLocale::LongNumber));
     case MonthComponent:
-        if (options.contains("text")) {
-            const bool possessiveForm = (options.contains("possessive") ? options["possessive"].toBool() : KGlobal::locale()->dateMonthNamePossessive());
+        if (options.testFlag(TextOption)) {
+            const bool possessiveForm = ((options.possessive != DefaultState) ? (options.possessive == EnabledState) : KGlobal::locale()->dateMonthNamePossessive());
 
-            return m_applet->calendar()->monthName(dateTime.date(), (options.contains("short") ? (possessiveForm ? KCalendarSystem::ShortNamePossessive : KCalendarSystem::ShortName) : (possessiveForm ? KCalendarSystem::LongNamePossessive : KCalendarSystem::LongName)));
+            return m_applet->calendar()->monthName(dateTime.date(), (options.testFlag(ShortOption) ? (possessiveForm ? KCalendarSystem::ShortNamePossessive : KCalendarSystem::ShortName) : (possessiveForm ? KCalendarSystem::LongNamePossessive : KCalendarSystem::LongName)));
         }
 
-        return m_applet->calendar()->formatDate(dateTime.date(), KLocale::Month, (options.contains("short") ? KLocale::ShortNumber : KLocale::LongNumber));
+        return m_applet->calendar()->formatDate(dateTime.date(), KLocale::Month, (options.testFlag(ShortOption) ? KLocale::ShortNumber : KLocale::LongNumber));
     case YearComponent:
-        return m_applet->calendar()->formatDate(dateTime.date(), KLocale::Year, (options.contains("short") ? KLocale::ShortNumber : KLocale::LongNumber));
+        return m_applet->calendar()->formatDate(dateTime.date(), KLocale::Year, (options.testFlag(ShortOption) ? KLocale::ShortNumber : KLocale::LongNumber));
     case TimestampComponent:
+        if (m_prediction) {
+            const uint timestamp = QDateTime(dateTime.date(), dateTime.time(), Qt::UTC).addSecs(-m_timeZoneSeconds).toTime_t();
+
+            return (options.testFlag(MillisecondsOption) ? QString::number(qint64(timestamp) * 1000) : QString::number(timestamp));
+        }
+
+        if (options.testFlag(MillisecondsOption)) {
+            return QString::number(QDateTime::currentMSecsSinceEpoch());
+        }
+
         return QString::number(QDateTime::currentDateTimeUtc().toTime_t());
     case TimeComponent:
-        return KGlobal::locale()->formatTime(dateTime.time(), !options.contains("short"));
+        return KGlobal::locale()->formatTime(dateTime.time(), !options.testFlag(ShortOption));
     case DateComponent:
-        return KGlobal::locale()->formatDate(dateTime.date(), (options.contains("short") ? KLocale::ShortDate : KLocale::LongDate));
+        return KGlobal::locale()->formatDate(dateTime.date(), (options.testFlag(ShortOption) ? KLocale::ShortDate : KLocale::LongDate));
     case DateTimeComponent:
-        return KGlobal::locale()->formatDateTime(dateTime, (options.contains("short") ? KLocale::ShortDate : KLocale::LongDate));
+        return KGlobal::locale()->formatDateTime(dateTime, (options.testFlag(ShortOption) ? KLocale::ShortDate : KLocale::LongDate));
     case TimeZoneNameComponent:
         return m_timeZoneArea;
     case TimeZoneAbbreviationComponent:
@@ -290,14 +480,19 @@ QVariant DataSource::getValue(ClockComponent component, const QVariantMap &optio
 
         return QString();
     case EventsComponent:
-        if (!m_events.isEmpty()) {
+        if (!constant) {
+            requireFeature(EventsFeature);
+        }
+
+        if (!m_hub->getEvents().isEmpty()) {
+            const QList<Event> entries = m_hub->getEvents();
             QStringList events;
 
-            for (int i = 0; i < m_events.count(); ++i) {
-                if (options.contains("short")) {
-                    events.append(QString("<td align=\"right\"><nobr><i>%1</i>:</nobr></td>\n<td align=\"left\">%2</td>\n").arg(m_events.at(i).type).arg(m_events.at(i).summary));
+            for (int i = 0; i < entries.count(); ++i) {
+                if (options.testFlag(ShortOption)) {
+                    events.append(QString("<td align=\"right\"><nobr><i>%1</i>:</nobr></td>\n<td align=\"left\">%2</td>\n").arg(entries.at(i).type).arg(entries.at(i).summary));
                 } else {
-                    events.append(QString("<td align=\"right\"><nobr><i>%1</i>:</nobr></td>\n<td align=\"left\">%2 <nobr>(%3)</nobr></td>\n").arg(m_events.at(i).type).arg(m_events.at(i).summary).arg(m_events.at(i).time));
+                    events.append(QString("<td align=\"right\"><nobr><i>%1</i>:</nobr></td>\n<td align=\"left\">%2 <nobr>(%3)</nobr></td>\n").arg(entries.at(i).type).arg(entries.at(i).summary).arg(entries.at(i).time));
                 }
             }
 
@@ -306,11 +501,27 @@ QVariant DataSource::getValue(ClockComponent component, const QVariantMap &optio
 
         return QString();
     case HolidaysComponent:
-        return (constant ? i18n("New Year") : (options.contains("short") ? (m_holidays.isEmpty() ? QString() : m_holidays.last()) : m_holidays.join("<br>\n")));
+        if (constant) {
+            return i18n("New Year");
+        }
+
+        requireFeature(HolidaysFeature);
+
+        return (options.testFlag(ShortOption) ? (m_hub->getHolidays().isEmpty() ? QString() : m_hub->getHolidays().last()) : m_hub->getHolidays().join("<br>\n"));
     case SunriseComponent:
-        return KGlobal::locale()->formatTime(m_sunrise, false);
+        if (!constant) {
+            requireFeature(SolarFeature);
+        }
+
+        return KGlobal::locale()->formatTime(m_hub->getSunrise(), false);
     case SunsetComponent:
-        return KGlobal::locale()->formatTime(m_sunset, false);
+        if (!constant) {
+            requireFeature(SolarFeature);
+        }
+
+        return KGlobal::locale()->formatTime(m_hub->getSunset(), false);
+    case MillisecondComponent:
+        return formatNumber(((constant || m_prediction || m_hub->getElapsed() < 0) ? 0 : qMin(m_hub->getElapsed(), 999)), (options.testFlag(ShortOption) ? 0 : 3));
     default:
         return QString();
     }
@@ -21,6 +21,10 @@
 #ifndef ADJUSTABLECLOCKDATASOURCE_HEADER
 #define ADJUSTABLECLOCKDATASOURCE_HEADER
 
+#include "Export.h"
+
+#include <QtCore/QElapsedTimer>
+
 #include <Plasma/DataEngine>
 
 namespace AdjustableClock
@@ -51,19 +55,58 @@ enum ClockComponent
     HolidaysComponent = 20,
     SunriseComponent = 21,
     SunsetComponent = 22,
-//     ForecastDurationComponent = 23,
-//     TemperatureCurrentComponent = 24,
-//     TemperatureMinimumComponent = 25,
-//     TemperatureMaximumComponent = 26,
-//     ConditionsComponent = 27,
-//     WindDirectionComponent = 28,
-//     WindSpeedComponent = 29,
-//     PressureComponent = 30,
-//     HumidityComponent = 31,
-//     LocationComponent = 32,
-    LastComponent = 23
+    MillisecondComponent = 23,
+//     ForecastDurationComponent = 24,
+//     TemperatureCurrentComponent = 25,
+//     TemperatureMinimumComponent = 26,
+//     TemperatureMaximumComponent = 27,
+//     ConditionsComponent = 28,
+//     WindDirectionComponent = 29,
+//     WindSpeedComponent = 30,
+//     PressureComponent = 31,
+//     HumidityComponent = 32,
+//     LocationComponent = 33,
+    LastComponent = 24
+};
+
+enum ComponentOption
+{
+    NoOption = 0,
+    ShortOption = 1,
+    TextOption = 2,
+    MillisecondsOption = 4
+};
+
+enum OptionState
+{
+    DefaultState = 0,
+    EnabledState = 1,
+    DisabledState = 2
 };
 
+struct ADJUSTABLECLOCK_EXPORT ComponentOptions
+{
+    explicit ComponentOptions(int flags = NoOption, OptionState alternative = DefaultState, OptionState possessive = DefaultState);
+
+    bool testFlag(ComponentOption option) const;
+    int getKey() const;
+    int getCount() const;
+    QString toString() const;
+    QVariantMap toMap() const;
+    bool operator==(const ComponentOptions &other) const;
+    static ComponentOptions fromMap(const QVariantMap &map);
+    static ComponentOptions fromString(const QString &options);
+
+    quint8 flags;
+    quint8 alternative;
+    quint8 possessive;
+};
+
+inline uint qHash(const ComponentOptions &options)
+{
+    return options.getKey();
+}
+
 struct Event
 {
     QString type;
@@ -72,49 +115,60 @@ struct Event
 };
 
 class Applet;
+class DataHub;
 
-class DataSource : public QObject
+class ADJUSTABLECLOCK_EXPORT DataSource : public QObject
 {
     Q_OBJECT
 
     public:
         explicit DataSource(Applet *applet);
+        ~DataSource();
 
+        void setPrediction(bool enabled);
         void updateTimeZone();
+        void resetFeatures();
+        QList<ClockComponent> getPredictedComponents() const;
+        QDateTime getDateTime() const;
         QVariant getOption(const QString &key, const QVariant &defaultValue, const QString &theme = QString()) const;
-        QVariant getValue(ClockComponent component, const QVariantMap &options = QVariantMap(), bool constant = false) const;
+        QVariantMap getOptions(const QString &theme = QString()) const;
+        QVariant getValue(ClockComponent component, const ComponentOptions &options = ComponentOptions(), bool constant = false) const;
 
     protected:
+        void requireFeature(int feature) const;
+        void releaseFeatures();
+        QList<ClockComponent> getChangedComponents(const QDateTime &previous, const QDateTime &current, bool reload = false) const;
         static QString formatNumber(int number, int length);
 
     protected slots:
-        void dataUpdated(const QString &name, const Plasma::DataEngine::Data &data, bool reload = false);
+        void updateTime(bool reload = false);
+        void releaseStaleFeatures();
 
     private:
         Applet *m_applet;
+        DataHub *m_hub;
         QDateTime m_dateTime;
         QDateTime m_constantDateTime;
-        QTime m_sunrise;
-        QTime m_sunset;
         QString m_timeZoneAbbreviation;
         QString m_timeZoneOffset;
-        QString m_timeQuery;
-        QString m_eventsQuery;
 //         QString m_weatherQuery;
         QString m_timeZoneArea;
 //         QString m_location;
 //         QString m_conditionsText;
 //         QString m_conditionsIcon;
 //         QString m_windDirection;
-        QStringList m_holidays;
-        QList<Event> m_events;
         QMap<QString, QString> m_timeZones;
+        mutable int m_features;
+        mutable int m_staleFeatures;
+        int m_timeZoneSeconds;
 //         int m_windSpeed;
 //         int m_pressure;
 //         int m_humidity;
 //         int m_temperatureCurrent;
 //         int m_temperatureMinimum;
 //         int m_temperatureMaximum;
+        bool m_prediction;
+        bool m_resetPending;
 
     signals:
         void componentChanged(ClockComponent component);
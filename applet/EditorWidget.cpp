@@ -20,6 +20,8 @@
 
 #include "EditorWidget.h"
 #include "ThemeWidget.h"
+#include "NativeTheme.h"
+#include "ClockContext.h"
 
 #include <QtCore/QFileInfo>
 #include <QtGui/QMouseEvent>
@@ -43,7 +45,8 @@ EditorWidget::EditorWidget(const QString &path, Clock *clock, QWidget *parent) :
     m_widget(NULL),
     m_document(NULL),
     m_path(path),
-    m_qml(QFile::exists(path + "/contents/ui/main.qml"))
+    m_qml(QFile::exists(path + "/contents/ui/main.qml")),
+    m_native(!m_qml && QFile::exists(path + "/contents/ui/main.xml") && !QFile::exists(path + "/contents/ui/main.html"))
 {
     const Plasma::PackageMetadata metaData(path + "/metadata.desktop");
 
@@ -68,8 +71,8 @@ EditorWidget::EditorWidget(const QString &path, Clock *clock, QWidget *parent) :
     }
 
     m_document = editor->createDocument(this);
-    m_document->openUrl(KUrl(path + "/contents/ui/main." + (m_qml ? "qml" : "html")));
-    m_document->setHighlightingMode(m_qml ? "qml" : "html");
+    m_document->openUrl(KUrl(path + "/contents/ui/main." + (m_qml ? "qml" : (m_native ? "xml" : "html"))));
+    m_document->setHighlightingMode(m_qml ? "qml" : (m_native ? "XML" : "html"));
 
     KTextEditor::View *view = m_document->createView(m_editorUi.sourceTab);
     view->setContextMenu(view->defaultContextMenu());
@@ -86,7 +89,7 @@ EditorWidget::EditorWidget(const QString &path, Clock *clock, QWidget *parent) :
 
     connect(m_editorUi.componentWidget, SIGNAL(insertComponent(QString,QString)), this, SLOT(insertComponent(QString,QString)));
 
-    if (m_qml) {
+    if (m_qml || m_native) {
         m_editorUi.editorLayout->addWidget(view);
         m_editorUi.tabWidget->setVisible(false);
         m_editorUi.controlsWidget->setVisible(false);
@@ -179,16 +182,22 @@ void EditorWidget::insertComponent(const QString &component, const QString &opti
         return;
     }
 
-    const QString value = m_clock->evaluate((options.isEmpty() ? QString("Clock.getValue(Clock.%1)").arg(component) : QString("Clock.getValue(Clock.%1, {%2})").arg(component).arg(options)));
-
     if (m_qml) {
-        m_document->activeView()->insertText(options.isEmpty() ? QString("Text\n{\n\tproperty variant adjustableClock: {component: '%1'}\n\ttext: '%2'\n}\n").arg(component).arg(value) : QString("Text\n{\n\tproperty variant adjustableClock: {component: '%1', options: '%2'}\n\ttext: '%3'\n}\n").arg(component).arg(options).arg(value));
+        m_document->activeView()->insertText(QString("Text\n{\n\ttext: clock.%1\n}\n").arg(ClockContext::getPropertyName(Clock::getComponent(component), ComponentOptions::fromString(options))));
+        m_document->activeView()->setFocus();
+
+        return;
+    }
+
+    if (m_native) {
+        m_document->activeView()->insertText(options.isEmpty() ? QString("<component name=\"%1\"/>").arg(component) : QString("<component name=\"%1\" options=\"%2\"/>").arg(component).arg(options));
         m_document->activeView()->setFocus();
 
         return;
     }
 
-    const QString title = Clock::getComponentName(static_cast<ClockComponent>(m_clock->evaluate(QString("Clock.%1").arg(component)).toInt()));
+    const QString value = m_clock->getValue(Clock::getComponent(component), ComponentOptions::fromString(options)).toString();
+    const QString title = Clock::getComponentName(Clock::getComponent(component));
 
     if (m_editorUi.tabWidget->currentIndex() > 0) {
         m_document->activeView()->insertText(options.isEmpty() ? QString("<span component=\"%1\" title=\"%2\">%3</span>").arg(component).arg(title).arg(value) : QString("<span component=\"%1\" options=\"%2\" title=\"%3\">%4</span>").arg(component).arg(options).arg(title).arg(value));
@@ -288,7 +297,7 @@ void EditorWidget::updateWebView(const QString &theme)
     const QWebElementCollection elements = m_widget->getPage()->mainFrame()->findAllElements("[component]");
 
     for (int i = 0; i < elements.count(); ++i) {
-        elements.at(i).setAttribute("title", Clock::getComponentName(static_cast<ClockComponent>(m_clock->evaluate(QString("Clock.%1").arg(elements.at(i).attribute("component"))).toInt())));
+        elements.at(i).setAttribute("title", Clock::getComponentName(Clock::getComponent(elements.at(i).attribute("component"))));
     }
 }
 
@@ -362,12 +371,20 @@ void EditorWidget::setZoom(int zoom)
 
 bool EditorWidget::saveTheme()
 {
-    if (!m_qml && m_editorUi.tabWidget->currentIndex() == 0) {
+    if (!m_qml && !m_native && m_editorUi.tabWidget->currentIndex() == 0) {
         updateEditor();
     }
 
-    if (m_document) {
-        return m_document->documentSave();
+    if (!m_document) {
+        return true;
+    }
+
+    if (!m_document->documentSave()) {
+        return false;
+    }
+
+    if (!m_qml && !m_native && QFile::exists(m_path + "/contents/ui/main.xml")) {
+        return QFile::remove(m_path + "/contents/ui/main.xml");
     }
 
     return true;
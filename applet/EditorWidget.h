@@ -67,6 +67,7 @@ class EditorWidget : public QWidget
         KTextEditor::Document *m_document;
         QString m_path;
         bool m_qml;
+        bool m_native;
         Ui::editor m_editorUi;
 };
 
@@ -58,6 +58,20 @@ void ExpressionLineEdit::insertComponent()
 
 void ExpressionLineEdit::insertComponent(const QString &component, const QString &options)
 {
+    if (text().isEmpty() || Format::isFormat(text())) {
+        const QVariantMap map = ComponentOptions::fromString(options).toMap();
+        QStringList values;
+        QVariantMap::const_iterator iterator;
+
+        for (iterator = map.constBegin(); iterator != map.constEnd(); ++iterator) {
+            values.append(iterator.value().toBool() ? iterator.key() : QString("%1=false").arg(iterator.key()));
+        }
+
+        insert(values.isEmpty() ? QString("%{%1}").arg(component) : QString("%{%1:%2}").arg(component).arg(values.join(QLatin1String(","))));
+
+        return;
+    }
+
     insert(options.isEmpty() ? QString("Clock.getValue(Clock.%1)").arg(component) : QString("Clock.getValue(Clock.%1, {%2})").arg(component).arg(options));
 }
 
@@ -0,0 +1,227 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#include "Format.h"
+#include "Clock.h"
+
+#include <KLocalizedString>
+
+namespace AdjustableClock
+{
+
+Format::Format() : m_valid(false)
+{
+}
+
+bool Format::compile(const QString &expression)
+{
+    m_tokens.clear();
+
+    m_error = QString();
+    m_valid = (isFormat(expression) ? compileFormat(expression) : compileExpression(expression));
+
+    if (!m_valid) {
+        m_tokens.clear();
+    }
+
+    return m_valid;
+}
+
+bool Format::compileFormat(const QString &format)
+{
+    QString text;
+    int position = 0;
+
+    while (position < format.length()) {
+        if (format.at(position) != QLatin1Char('%') || (position + 1) >= format.length()) {
+            text.append(format.at(position));
+
+            ++position;
+
+            continue;
+        }
+
+        if (format.at(position + 1) == QLatin1Char('%')) {
+            text.append(QLatin1Char('%'));
+
+            position += 2;
+
+            continue;
+        }
+
+        if (format.at(position + 1) != QLatin1Char('{')) {
+            text.append(format.at(position));
+
+            ++position;
+
+            continue;
+        }
+
+        const int end = format.indexOf(QLatin1Char('}'), position);
+
+        if (end < 0) {
+            m_error = i18n("Unterminated component at position %1", (position + 1));
+
+            return false;
+        }
+
+        const QString token = format.mid((position + 2), (end - position - 2));
+        const ClockComponent component = Clock::getComponent(token.section(QLatin1Char(':'), 0, 0).trimmed());
+
+        if (component == InvalidComponent) {
+            m_error = i18n("Unknown component: %1", token.section(QLatin1Char(':'), 0, 0).trimmed());
+
+            return false;
+        }
+
+        const QStringList values = token.section(QLatin1Char(':'), 1).split(QLatin1Char(','), QString::SkipEmptyParts);
+        QVariantMap map;
+
+        for (int i = 0; i < values.count(); ++i) {
+            const QString key = values.at(i).section(QLatin1Char('='), 0, 0).trimmed();
+            const QString value = values.at(i).section(QLatin1Char('='), 1).trimmed();
+
+            if (!value.isEmpty() && value != "true" && value != "false") {
+                m_error = i18n("Invalid value of option %1: %2", key, value);
+
+                return false;
+            }
+
+            if (value != "false" || key == "alternative" || key == "possessive") {
+                map[key] = (value != "false");
+            }
+        }
+
+        appendText(text);
+        appendComponent(component, ComponentOptions::fromMap(map));
+
+        text.clear();
+
+        position = (end + 1);
+    }
+
+    appendText(text);
+
+    return true;
+}
+
+bool Format::compileExpression(const QString &expression)
+{
+    QRegExp valueExpression("\\s*Clock\\.getValue\\(\\s*Clock\\.(\\w+)\\s*(,\\s*\\{([^}]*)\\}\\s*)?\\)\\s*");
+    QRegExp textExpression("\\s*('([^'\\\\]*)'|\"([^\"\\\\]*)\")\\s*");
+    QRegExp separatorExpression("\\+");
+    int position = 0;
+
+    while (position < expression.length()) {
+        if (valueExpression.indexIn(expression, position, QRegExp::CaretAtOffset) == position) {
+            const ClockComponent component = Clock::getComponent(valueExpression.cap(1));
+
+            if (component == InvalidComponent) {
+                return false;
+            }
+
+            appendComponent(component, ComponentOptions::fromString(valueExpression.cap(3)));
+
+            position += valueExpression.matchedLength();
+        } else if (textExpression.indexIn(expression, position, QRegExp::CaretAtOffset) == position) {
+            appendText(textExpression.cap(2).isEmpty() ? textExpression.cap(3) : textExpression.cap(2));
+
+            position += textExpression.matchedLength();
+        } else {
+            return false;
+        }
+
+        if (position >= expression.length()) {
+            break;
+        }
+
+        if (separatorExpression.indexIn(expression, position, QRegExp::CaretAtOffset) != position) {
+            return false;
+        }
+
+        position += separatorExpression.matchedLength();
+
+        if (position >= expression.length()) {
+            return false;
+        }
+    }
+
+    return !m_tokens.isEmpty();
+}
+
+void Format::appendText(const QString &text)
+{
+    if (text.isEmpty()) {
+        return;
+    }
+
+    if (!m_tokens.isEmpty() && m_tokens.last().component == InvalidComponent) {
+        m_tokens.last().text.append(text);
+
+        return;
+    }
+
+    FormatToken token;
+    token.component = InvalidComponent;
+    token.text = text;
+
+    m_tokens.append(token);
+}
+
+void Format::appendComponent(ClockComponent component, const ComponentOptions &options)
+{
+    FormatToken token;
+    token.component = component;
+    token.options = options;
+
+    m_tokens.append(token);
+}
+
+bool Format::isValid() const
+{
+    return m_valid;
+}
+
+bool Format::isFormat(const QString &expression)
+{
+    return (!expression.contains(QLatin1String("Clock.")) && expression.contains(QRegExp("%\\{[^}]*\\}")));
+}
+
+QString Format::getError() const
+{
+    return m_error;
+}
+
+QString Format::evaluate(const Clock *clock) const
+{
+    QString result;
+
+    for (int i = 0; i < m_tokens.count(); ++i) {
+        if (m_tokens.at(i).component == InvalidComponent) {
+            result.append(m_tokens.at(i).text);
+        } else {
+            result.append(clock->getValue(m_tokens.at(i).component, m_tokens.at(i).options).toString());
+        }
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,63 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#ifndef ADJUSTABLECLOCKFORMAT_HEADER
+#define ADJUSTABLECLOCKFORMAT_HEADER
+
+#include "DataSource.h"
+
+namespace AdjustableClock
+{
+
+struct FormatToken
+{
+    ClockComponent component;
+    ComponentOptions options;
+    QString text;
+};
+
+class Clock;
+
+class Format
+{
+    public:
+        Format();
+
+        bool compile(const QString &expression);
+        bool isValid() const;
+        QString getError() const;
+        QString evaluate(const Clock *clock) const;
+        static bool isFormat(const QString &expression);
+
+    protected:
+        bool compileFormat(const QString &format);
+        bool compileExpression(const QString &expression);
+        void appendText(const QString &text);
+        void appendComponent(ClockComponent component, const ComponentOptions &options);
+
+    private:
+        QList<FormatToken> m_tokens;
+        QString m_error;
+        bool m_valid;
+};
+
+}
+
+#endif
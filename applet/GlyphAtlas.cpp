@@ -0,0 +1,185 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#include "GlyphAtlas.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QLineF>
+#include <QtCore/qmath.h>
+#include <QtGui/QPolygonF>
+#include <QtGui/QFontMetricsF>
+
+#include <Plasma/Theme>
+
+namespace AdjustableClock
+{
+
+GlyphAtlas* GlyphAtlas::m_instance = NULL;
+
+GlyphAtlas::GlyphAtlas(QObject *parent) : QObject(parent)
+{
+    m_atlases.setMaxCost(2097152);
+
+    connect(Plasma::Theme::defaultTheme(), SIGNAL(themeChanged()), this, SLOT(clear()));
+}
+
+GlyphAtlas* GlyphAtlas::getInstance()
+{
+    if (!m_instance) {
+        m_instance = new GlyphAtlas(QCoreApplication::instance());
+    }
+
+    return m_instance;
+}
+
+void GlyphAtlas::paintGlyph(QPainter *painter, const QPointF &position, const GlyphStyle &style, int state, qreal scale)
+{
+    const QSize size(qCeil(style.size.width() * scale), qCeil(style.size.height() * scale));
+
+    if (size.isEmpty() || state < 0 || state >= getStateCount(style)) {
+        return;
+    }
+
+    const QPixmap *atlas = getAtlas(style, size);
+
+    if (atlas) {
+        painter->drawPixmap(QRectF(position, style.size), *atlas, QRectF((state * size.width()), 0, size.width(), size.height()));
+    }
+}
+
+void GlyphAtlas::clear()
+{
+    m_atlases.clear();
+}
+
+QPixmap* GlyphAtlas::getAtlas(const GlyphStyle &style, const QSize &size)
+{
+    const QString key = getKey(style, size);
+    QPixmap *atlas = m_atlases.object(key);
+
+    if (atlas) {
+        return atlas;
+    }
+
+    const int count = getStateCount(style);
+
+    atlas = new QPixmap((size.width() * count), size.height());
+    atlas->fill(Qt::transparent);
+
+    QPainter painter(atlas);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
+    painter.scale((size.width() / style.size.width()), (size.height() / style.size.height()));
+
+    for (int i = 0; i < count; ++i) {
+        const QRectF rectangle(QPointF((i * style.size.width()), 0), style.size);
+
+        if (style.type == SegmentGlyph) {
+            paintSegments(&painter, rectangle, style, i);
+        } else if (style.type == CellGlyph) {
+            paintCells(&painter, rectangle, style, i);
+        } else if (i > 0 || style.blankOpacity > 0) {
+            QColor color = style.color;
+
+            if (i == 0) {
+                color.setAlphaF(color.alphaF() * style.blankOpacity);
+            }
+
+            painter.setFont(style.font);
+            painter.setPen(color);
+            painter.drawText(QPointF(rectangle.x(), QFontMetricsF(style.font).ascent()), style.text);
+        }
+    }
+
+    painter.end();
+
+    if (!m_atlases.insert(key, atlas, (atlas->width() * atlas->height()))) {
+        return NULL;
+    }
+
+    return atlas;
+}
+
+void GlyphAtlas::paintSegments(QPainter *painter, const QRectF &rectangle, const GlyphStyle &style, int state)
+{
+    const int masks[] = {63, 6, 91, 79, 102, 109, 125, 7, 127, 111, 0};
+    const qreal thickness = (rectangle.width() * 0.14);
+    const qreal gap = (thickness * 0.2);
+    const qreal left = (rectangle.left() + (thickness / 2));
+    const qreal right = (rectangle.right() - (thickness / 2));
+    const qreal top = (rectangle.top() + (thickness / 2));
+    const qreal middle = rectangle.center().y();
+    const qreal bottom = (rectangle.bottom() - (thickness / 2));
+    const QLineF segments[] = {QLineF((left + gap), top, (right - gap), top), QLineF(right, (top + gap), right, (middle - gap)), QLineF(right, (middle + gap), right, (bottom - gap)), QLineF((left + gap), bottom, (right - gap), bottom), QLineF(left, (middle + gap), left, (bottom - gap)), QLineF(left, (top + gap), left, (middle - gap)), QLineF((left + gap), middle, (right - gap), middle)};
+    QColor blankColor = style.color;
+    blankColor.setAlphaF(blankColor.alphaF() * style.blankOpacity);
+
+    painter->setPen(Qt::NoPen);
+
+    for (int i = 0; i < 7; ++i) {
+        const bool lit = (masks[qBound(0, state, 10)] & (1 << i));
+
+        if (!lit && style.blankOpacity <= 0) {
+            continue;
+        }
+
+        const QPointF direction = (((segments[i].p2() - segments[i].p1()) / segments[i].length()) * (thickness / 2));
+        const QPointF normal(-direction.y(), direction.x());
+        QPolygonF polygon;
+        polygon << segments[i].p1() << (segments[i].p1() + direction + normal) << (segments[i].p2() - direction + normal) << segments[i].p2() << (segments[i].p2() - direction - normal) << (segments[i].p1() + direction - normal);
+
+        painter->setBrush(lit ? style.color : blankColor);
+        painter->drawPolygon(polygon);
+    }
+}
+
+void GlyphAtlas::paintCells(QPainter *painter, const QRectF &rectangle, const GlyphStyle &style, int state)
+{
+    const qreal cell = (rectangle.height() / style.cells);
+
+    painter->setPen(QPen(style.borderColor, 1));
+
+    for (int i = 0; i < style.cells; ++i) {
+        painter->setBrush((state & (1 << (style.cells - i - 1))) ? QBrush(style.color) : QBrush(Qt::NoBrush));
+        painter->drawRect(QRectF((rectangle.left() + 0.5), (rectangle.top() + (i * cell) + 0.5), (rectangle.width() - 1), (cell - 1)));
+    }
+}
+
+int GlyphAtlas::getStateCount(const GlyphStyle &style)
+{
+    switch (style.type) {
+    case SegmentGlyph:
+        return 11;
+    case CellGlyph:
+        return (1 << qBound(1, style.cells, 8));
+    case SeparatorGlyph:
+        return 2;
+    default:
+        return 0;
+    }
+
+    return 0;
+}
+
+QString GlyphAtlas::getKey(const GlyphStyle &style, const QSize &size)
+{
+    return (QString("%1:%2x%3:%4x%5:%6:%7").arg(style.type).arg(size.width()).arg(size.height()).arg(style.size.width()).arg(style.size.height()).arg(style.blankOpacity).arg(style.cells) + QString(":%1:%2:%3:%4").arg(QString::number(style.color.rgba(), 16)).arg(QString::number(style.borderColor.rgba(), 16)).arg(style.font.toString()).arg(style.text));
+}
+
+}
@@ -0,0 +1,81 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#ifndef ADJUSTABLECLOCKGLYPHATLAS_HEADER
+#define ADJUSTABLECLOCKGLYPHATLAS_HEADER
+
+#include <QtCore/QCache>
+#include <QtGui/QFont>
+#include <QtGui/QColor>
+#include <QtGui/QPixmap>
+#include <QtGui/QPainter>
+
+namespace AdjustableClock
+{
+
+enum GlyphType
+{
+    NoGlyph = 0,
+    SegmentGlyph = 1,
+    CellGlyph = 2,
+    SeparatorGlyph = 3
+};
+
+struct GlyphStyle
+{
+    GlyphType type;
+    QSizeF size;
+    QFont font;
+    QString text;
+    QColor color;
+    QColor borderColor;
+    qreal blankOpacity;
+    int cells;
+};
+
+class GlyphAtlas : public QObject
+{
+    Q_OBJECT
+
+    public:
+        static GlyphAtlas* getInstance();
+        void paintGlyph(QPainter *painter, const QPointF &position, const GlyphStyle &style, int state, qreal scale);
+        static int getStateCount(const GlyphStyle &style);
+
+    protected:
+        explicit GlyphAtlas(QObject *parent = NULL);
+
+        QPixmap* getAtlas(const GlyphStyle &style, const QSize &size);
+        static void paintSegments(QPainter *painter, const QRectF &rectangle, const GlyphStyle &style, int state);
+        static void paintCells(QPainter *painter, const QRectF &rectangle, const GlyphStyle &style, int state);
+        static QString getKey(const GlyphStyle &style, const QSize &size);
+
+    protected slots:
+        void clear();
+
+    private:
+        QCache<QString, QPixmap> m_atlases;
+
+        static GlyphAtlas *m_instance;
+};
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#include "ImageProvider.h"
+
+#include <KIcon>
+#include <KGlobalSettings>
+
+#include <Plasma/Svg>
+#include <Plasma/Theme>
+
+namespace AdjustableClock
+{
+
+QCache<QString, QPixmap> ImageProvider::m_cache(4194304);
+
+ImageProvider::ImageProvider() : QObject(), QDeclarativeImageProvider(QDeclarativeImageProvider::Pixmap)
+{
+    connect(KGlobalSettings::self(), SIGNAL(iconChanged(int)), this, SLOT(clearCache()));
+    connect(Plasma::Theme::defaultTheme(), SIGNAL(themeChanged()), this, SLOT(clearCache()));
+}
+
+QPixmap ImageProvider::requestPixmap(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    const QString type = id.section(QLatin1Char('/'), 0, 0);
+    QString path = id.section(QLatin1Char('/'), 1);
+    QSize pixmapSize = requestedSize;
+
+    if (type == "icon") {
+        const int extent = qMax(qMax(requestedSize.width(), requestedSize.height()), path.section(QLatin1Char('/'), 0, 0).toInt());
+
+        path = path.section(QLatin1Char('/'), 1);
+        pixmapSize = QSize(((extent > 0) ? extent : 64), ((extent > 0) ? extent : 64));
+    } else if (type != "image") {
+        return QPixmap();
+    }
+
+    const QString key = QString("%1/%2x%3/%4").arg(type).arg(pixmapSize.width()).arg(pixmapSize.height()).arg(path);
+    QPixmap *cachedPixmap = m_cache.object(key);
+
+    if (cachedPixmap) {
+        if (size) {
+            *size = cachedPixmap->size();
+        }
+
+        return *cachedPixmap;
+    }
+
+    QPixmap pixmap;
+
+    if (type == "icon") {
+        pixmap = KIcon(path).pixmap(pixmapSize);
+    } else {
+        Plasma::Svg svg;
+        svg.setImagePath(path);
+
+        if (!svg.isValid()) {
+            return QPixmap();
+        }
+
+        if (pixmapSize.width() > 0 && pixmapSize.height() > 0) {
+            svg.resize(pixmapSize);
+        }
+
+        pixmap = svg.pixmap();
+    }
+
+    if (size) {
+        *size = pixmap.size();
+    }
+
+    m_cache.insert(key, new QPixmap(pixmap), (pixmap.width() * pixmap.height()));
+
+    return pixmap;
+}
+
+void ImageProvider::clearCache()
+{
+    m_cache.clear();
+}
+
+}
@@ -0,0 +1,930 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#include "NativeTheme.h"
+#include "Clock.h"
+
+#include <QtCore/QRegExp>
+#include <QtGui/QImage>
+#include <QtGui/QTextDocument>
+#include <QtGui/QLinearGradient>
+#include <QtGui/QFontMetricsF>
+
+#include <Plasma/Theme>
+
+namespace AdjustableClock
+{
+
+NativeTheme::NativeTheme(Clock *clock, QObject *parent) : QObject(parent),
+    m_clock(clock),
+    m_reflection(0),
+    m_background(false)
+{
+}
+
+bool NativeTheme::setDescription(const QString &description)
+{
+    QXmlStreamReader reader(description);
+
+    m_lines.clear();
+    m_attributes.clear();
+
+    while (!reader.atEnd()) {
+        reader.readNext();
+
+        if (!reader.isStartElement()) {
+            continue;
+        }
+
+        if (reader.name() == QLatin1String("clock")) {
+            m_attributes = getAttributes(reader, QHash<QString, QString>());
+        } else if (reader.name() == QLatin1String("line")) {
+            NativeLine line;
+            line.attributes = getAttributes(reader, m_attributes);
+            line.ascent = 0;
+            line.visible = true;
+
+            if (reader.attributes().hasAttribute("visible")) {
+                line.visibility.append(reader.attributes().value("visible").toString());
+            }
+
+            parseLine(reader, line, line.attributes, QStringList());
+
+            m_lines.append(line);
+        }
+    }
+
+    if (reader.hasError()) {
+        m_lines.clear();
+    }
+
+    return !m_lines.isEmpty();
+}
+
+void NativeTheme::parseLine(QXmlStreamReader &reader, NativeLine &line, const QHash<QString, QString> &attributes, const QStringList &visibility)
+{
+    while (!reader.atEnd()) {
+        reader.readNext();
+
+        if (reader.isEndElement()) {
+            return;
+        }
+
+        NativeRun run;
+        run.component = InvalidComponent;
+        run.attributes = attributes;
+        run.visibility = visibility;
+        run.glyph.type = NoGlyph;
+        run.glyph.blankOpacity = 0;
+        run.glyph.cells = 0;
+        run.opacity = 1;
+        run.ascent = 0;
+        run.digit = 0;
+        run.state = -1;
+        run.visible = true;
+
+        if (reader.isCharacters()) {
+            if (reader.isWhitespace() && reader.text().toString().contains(QLatin1Char('\n'))) {
+                continue;
+            }
+
+            run.text = reader.text().toString();
+
+            line.runs.append(run);
+
+            continue;
+        }
+
+        if (!reader.isStartElement()) {
+            continue;
+        }
+
+        run.attributes = getAttributes(reader, attributes);
+
+        if (reader.attributes().hasAttribute("visible")) {
+            run.visibility.append(reader.attributes().value("visible").toString());
+        }
+
+        if (reader.name() == QLatin1String("segments")) {
+            run.glyph.type = SegmentGlyph;
+        } else if (reader.name() == QLatin1String("cells")) {
+            run.glyph.type = CellGlyph;
+        } else if (reader.name() == QLatin1String("separator")) {
+            run.glyph.type = SeparatorGlyph;
+        }
+
+        if (reader.name() == QLatin1String("component") || run.glyph.type != NoGlyph) {
+            run.component = Clock::getComponent(reader.attributes().value((run.glyph.type == NoGlyph) ? "name" : "component").toString());
+
+            run.options = ComponentOptions::fromString(reader.attributes().value("options").toString());
+            run.text = reader.attributes().value("text").toString();
+            run.digit = reader.attributes().value("digit").toString().toInt();
+
+            if (run.component != InvalidComponent) {
+                line.runs.append(run);
+            }
+
+            reader.skipCurrentElement();
+        } else if (reader.name() == QLatin1String("text")) {
+            run.text = reader.readElementText();
+
+            line.runs.append(run);
+        } else {
+            parseLine(reader, line, run.attributes, run.visibility);
+        }
+    }
+}
+
+void NativeTheme::updateOptions()
+{
+    m_background = resolve(m_attributes.value("background"), false).toBool();
+    m_reflection = qBound(qreal(0), resolve(m_attributes.value("reflection"), qreal(0)).toReal(), qreal(1));
+
+    for (int i = 0; i < m_lines.count(); ++i) {
+        m_lines[i].visible = isVisible(m_lines.at(i).visibility);
+
+        for (int j = 0; j < m_lines.at(i).runs.count(); ++j) {
+            updateStyle(m_lines[i].runs[j]);
+        }
+    }
+
+    updateLayout();
+}
+
+void NativeTheme::updateStyle(NativeRun &run)
+{
+    const QFont defaultFont = Plasma::Theme::defaultTheme()->font(Plasma::Theme::DefaultFont);
+    QColor color = resolve(run.attributes.value("color"), Plasma::Theme::defaultTheme()->color(Plasma::Theme::TextColor)).value<QColor>();
+    QString opacityExpression = run.attributes.value("opacity");
+    const bool percentage = opacityExpression.endsWith(QLatin1Char('%'));
+
+    if (percentage) {
+        opacityExpression.chop(1);
+    }
+
+    qreal opacity = resolve(opacityExpression, qreal(percentage ? 100 : 1)).toReal();
+    const QStringList offset = run.attributes.value("offset").split(QLatin1Char(','), QString::SkipEmptyParts);
+
+    if (!color.isValid()) {
+        color = Plasma::Theme::defaultTheme()->color(Plasma::Theme::TextColor);
+    }
+
+    if (percentage) {
+        opacity /= 100;
+    }
+
+    run.font = QFont(resolve(run.attributes.value("font"), defaultFont.family()).toString());
+    run.font.setPixelSize(qMax(1, qRound(resolve(run.attributes.value("size"), qreal(16)).toReal())));
+    run.font.setBold(resolve(run.attributes.value("bold"), false).toBool());
+    run.font.setItalic(resolve(run.attributes.value("italic"), false).toBool());
+    run.color = color;
+    run.opacity = qBound(qreal(0), opacity, qreal(1));
+    run.offset = ((offset.count() == 2) ? QPointF(offset.at(0).toDouble(), offset.at(1).toDouble()) : QPointF());
+    run.ascent = QFontMetricsF(run.font).ascent();
+    run.visible = isVisible(run.visibility);
+
+    if (run.glyph.type != NoGlyph) {
+        qreal blankOpacity = resolve(run.attributes.value("blank"), qreal(0)).toReal();
+        QColor borderColor = resolve(run.attributes.value("border"), QColor("#DDD")).value<QColor>();
+
+        if (!borderColor.isValid()) {
+            borderColor = QColor("#DDD");
+        }
+
+        run.glyph.font = run.font;
+        run.glyph.color = run.color;
+        run.glyph.borderColor = borderColor;
+        run.glyph.blankOpacity = (qBound(qreal(0), blankOpacity, qreal(100)) / 100);
+        run.glyph.cells = qBound(1, resolve(run.attributes.value("count"), 4).toInt(), 8);
+
+        if (run.glyph.type == SegmentGlyph) {
+            run.glyph.size = QSizeF(resolve(run.attributes.value("width"), qreal(30)).toReal(), resolve(run.attributes.value("height"), qreal(60)).toReal());
+        } else if (run.glyph.type == CellGlyph) {
+            const qreal cell = resolve(run.attributes.value("cell"), qreal(11)).toReal();
+
+            run.glyph.size = QSizeF(cell, (cell * run.glyph.cells));
+        } else {
+            run.glyph.text = run.text;
+            run.glyph.size = QSizeF(QFontMetricsF(run.font).width(run.text), QFontMetricsF(run.font).height());
+        }
+
+        run.size = run.glyph.size;
+        run.ascent = ((run.glyph.type == SeparatorGlyph) ? run.ascent : run.size.height());
+        run.state = -1;
+
+        updateText(run);
+
+        return;
+    }
+
+    run.staticText.setTextFormat((run.component == InvalidComponent) ? Qt::PlainText : Qt::AutoText);
+    run.staticText.setPerformanceHint(QStaticText::AggressiveCaching);
+
+    if (!updateText(run)) {
+        run.staticText.prepare(QTransform(), run.font);
+    }
+
+    run.size = run.staticText.size();
+}
+
+void NativeTheme::updateLayout()
+{
+    const QStringList padding = m_attributes.value("padding").split(QLatin1Char(','), QString::SkipEmptyParts);
+    QList<qreal> margins;
+
+    for (int i = 0; i < 4; ++i) {
+        margins.append(padding.isEmpty() ? 0 : padding.value(((padding.count() == 4) ? i : ((padding.count() == 2) ? (i % 2) : 0))).toDouble());
+    }
+
+    qreal width = 0;
+    qreal height = 0;
+
+    for (int i = 0; i < m_lines.count(); ++i) {
+        NativeLine &line = m_lines[i];
+
+        if (!line.visible) {
+            continue;
+        }
+
+        qreal lineWidth = 0;
+        qreal ascent = 0;
+        qreal descent = 0;
+
+        for (int j = 0; j < line.runs.count(); ++j) {
+            const NativeRun &run = line.runs.at(j);
+
+            if (!run.visible) {
+                continue;
+            }
+
+            lineWidth += run.size.width();
+            ascent = qMax(ascent, run.ascent);
+            descent = qMax(descent, (run.size.height() - run.ascent));
+        }
+
+        line.ascent = ascent;
+        line.rectangle = QRectF(0, height, lineWidth, (ascent + descent));
+
+        width = qMax(width, lineWidth);
+        height += line.rectangle.height();
+    }
+
+    for (int i = 0; i < m_lines.count(); ++i) {
+        const QString alignment = m_lines.at(i).attributes.value("align", "center");
+
+        if (alignment == "right") {
+            m_lines[i].rectangle.moveLeft(width - m_lines.at(i).rectangle.width());
+        } else if (alignment != "left") {
+            m_lines[i].rectangle.moveLeft((width - m_lines.at(i).rectangle.width()) / 2);
+        }
+    }
+
+    m_contents = QRectF(margins.at(3), margins.at(0), width, height);
+    m_size = QSizeF((width + margins.at(1) + margins.at(3)), ((height * (1 + m_reflection)) + margins.at(0) + margins.at(2)));
+}
+
+bool NativeTheme::updateComponent(ClockComponent component)
+{
+    bool changed = false;
+    bool resized = false;
+
+    for (int i = 0; i < m_lines.count(); ++i) {
+        for (int j = 0; j < m_lines.at(i).runs.count(); ++j) {
+            if (m_lines.at(i).runs.at(j).component != component) {
+                continue;
+            }
+
+            const QSizeF size = m_lines.at(i).runs.at(j).size;
+
+            if (updateText(m_lines[i].runs[j])) {
+                changed = true;
+
+                if (m_lines.at(i).runs.at(j).size != size) {
+                    resized = true;
+                }
+            }
+        }
+    }
+
+    if (resized) {
+        updateLayout();
+    }
+
+    return changed;
+}
+
+bool NativeTheme::updateText(NativeRun &run)
+{
+    if (run.glyph.type != NoGlyph) {
+        const QString value = m_clock->getValue(run.component, run.options).toString();
+        const QChar character = ((run.digit >= 0 && run.digit < value.length()) ? value.at(run.digit) : QChar());
+        int state = 0;
+
+        if (run.glyph.type == SegmentGlyph) {
+            state = (character.isDigit() ? character.digitValue() : 10);
+        } else if (run.glyph.type == CellGlyph) {
+            state = (character.isDigit() ? qMin(character.digitValue(), (GlyphAtlas::getStateCount(run.glyph) - 1)) : 0);
+        } else {
+            state = (value.toInt() % 2);
+        }
+
+        if (state == run.state) {
+            return false;
+        }
+
+        run.state = state;
+
+        return true;
+    }
+
+    const QString text = ((run.component == InvalidComponent) ? run.text : m_clock->getValue(run.component, run.options).toString());
+
+    if (text == run.staticText.text()) {
+        return false;
+    }
+
+    run.staticText.setText(text);
+    run.staticText.prepare(QTransform(), run.font);
+
+    run.size = run.staticText.size();
+
+    return true;
+}
+
+void NativeTheme::paint(QPainter *painter, const QRectF &rectangle)
+{
+    if (m_size.isEmpty() || rectangle.isEmpty()) {
+        return;
+    }
+
+    const qreal factor = qMin((rectangle.width() / m_size.width()), (rectangle.height() / m_size.height()));
+
+    painter->save();
+    painter->translate((rectangle.x() + ((rectangle.width() - (m_size.width() * factor)) / 2)), (rectangle.y() + ((rectangle.height() - (m_size.height() * factor)) / 2)));
+    painter->scale(factor, factor);
+    painter->translate(m_contents.topLeft());
+
+    paintContents(painter, factor);
+
+    if (m_reflection > 0 && !m_contents.isEmpty()) {
+        QImage image((m_contents.size() * factor).toSize(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(0);
+
+        QLinearGradient gradient(0, (image.height() * (1 - m_reflection)), 0, image.height());
+        gradient.setColorAt(0, QColor(0, 0, 0, 0));
+        gradient.setColorAt(1, QColor(0, 0, 0, 100));
+
+        QPainter imagePainter(&image);
+        imagePainter.setRenderHints(painter->renderHints());
+        imagePainter.scale(factor, factor);
+
+        paintContents(&imagePainter, factor);
+
+        imagePainter.resetTransform();
+        imagePainter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
+        imagePainter.fillRect(image.rect(), gradient);
+        imagePainter.end();
+
+        painter->translate(0, (m_contents.height() * 2));
+        painter->scale((1 / factor), (-1 / factor));
+        painter->drawImage(0, 0, image);
+    }
+
+    painter->restore();
+}
+
+void NativeTheme::paintContents(QPainter *painter, qreal scale)
+{
+    for (int i = 0; i < m_lines.count(); ++i) {
+        const NativeLine &line = m_lines.at(i);
+
+        if (!line.visible) {
+            continue;
+        }
+
+        qreal position = line.rectangle.x();
+
+        for (int j = 0; j < line.runs.count(); ++j) {
+            const NativeRun &run = line.runs.at(j);
+
+            if (!run.visible) {
+                continue;
+            }
+
+            const QPointF point = (QPointF(position, (line.rectangle.y() + line.ascent - run.ascent)) + run.offset);
+
+            painter->setOpacity(run.opacity);
+
+            if (run.glyph.type == NoGlyph) {
+                painter->setFont(run.font);
+                painter->setPen(run.color);
+                painter->drawStaticText(point, run.staticText);
+            } else {
+                GlyphAtlas::getInstance()->paintGlyph(painter, point, run.glyph, run.state, scale);
+            }
+
+            position += run.size.width();
+        }
+    }
+
+    painter->setOpacity(1);
+}
+
+bool NativeTheme::isVisible(const QStringList &visibility) const
+{
+    for (int i = 0; i < visibility.count(); ++i) {
+        if (!resolve(visibility.at(i), true).toBool()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QVariant NativeTheme::resolve(const QString &expression, const QVariant &defaultValue) const
+{
+    QRegExp optionExpression("\\{(\\w+)(?::(.*))?\\}");
+
+    if (optionExpression.exactMatch(expression)) {
+        QVariant value = m_clock->getOption(optionExpression.cap(1), (optionExpression.cap(2).isEmpty() ? defaultValue : resolve(optionExpression.cap(2), defaultValue)));
+
+        if (defaultValue.isValid() && value.type() != defaultValue.type() && !value.convert(defaultValue.type())) {
+            return defaultValue;
+        }
+
+        return value;
+    }
+
+    if (expression.isEmpty()) {
+        return defaultValue;
+    }
+
+    QVariant value(expression);
+
+    if (defaultValue.isValid() && !value.convert(defaultValue.type())) {
+        return defaultValue;
+    }
+
+    return value;
+}
+
+QSizeF NativeTheme::getSize() const
+{
+    return m_size;
+}
+
+bool NativeTheme::getBackgroundFlag() const
+{
+    return m_background;
+}
+
+QHash<QString, QString> NativeTheme::getAttributes(const QXmlStreamReader &reader, const QHash<QString, QString> &inherited)
+{
+    QHash<QString, QString> attributes = inherited;
+    const QXmlStreamAttributes elementAttributes = reader.attributes();
+
+    for (int i = 0; i < elementAttributes.count(); ++i) {
+        const QString name = elementAttributes.at(i).name().toString();
+
+        if (name != "visible" && name != "name" && name != "component" && name != "options" && name != "text" && name != "digit") {
+            attributes[name] = elementAttributes.at(i).value().toString();
+        }
+    }
+
+    return attributes;
+}
+
+QString NativeTheme::fromHtml(const QString &html)
+{
+    const QStringList headTags = (QStringList() << "html" << "head" << "meta" << "title");
+    const QStringList blockTags = (QStringList() << "body" << "div");
+    const QStringList inlineTags = (QStringList() << "span" << "b" << "strong" << "i" << "em" << "big" << "small");
+    const QStringList allowedAttributes = (QStringList() << "id" << "class" << "title");
+    QRegExp commentExpression("<!--.*-->");
+    commentExpression.setMinimal(true);
+    QRegExp tagExpression("<(/?)([a-zA-Z][a-zA-Z0-9]*)((?:[^>\"']|\"[^\"]*\"|'[^']*')*)>");
+    QRegExp attributeExpression("([a-zA-Z][a-zA-Z0-9\\-]*)(?:\\s*=\\s*(?:\"([^\"]*)\"|'([^']*)'|([^\\s\"'>]+)))?");
+    QString source = html;
+    source.remove(commentExpression);
+    source.remove(QRegExp("<![^>]*>"));
+    const QFont font = Plasma::Theme::defaultTheme()->font(Plasma::Theme::DefaultFont);
+    QHash<QString, QString> root;
+    root["font"] = font.family();
+    root["size"] = QString::number((font.pixelSize() > 0) ? qreal(font.pixelSize()) : ((font.pointSizeF() * 4) / 3));
+    root["opacity"] = "1";
+    root["align"] = "left";
+    QHash<QString, QString> lineBreak;
+    lineBreak["break"] = "true";
+    QList<QHash<QString, QString> > styles;
+    styles.append(root);
+    QList<QHash<QString, QString> > runs;
+    QStringList tags;
+    QString margin = "0,0,0,0";
+    QString padding = "0,0,0,0";
+    int skipDepth = 0;
+    int position = 0;
+    bool head = false;
+    bool background = false;
+
+    while (true) {
+        const int tagPosition = tagExpression.indexIn(source, position);
+        const QString text = source.mid(position, ((tagPosition < 0) ? -1 : (tagPosition - position)));
+
+        if (!head && skipDepth == 0 && !text.isEmpty()) {
+            QHash<QString, QString> run = styles.last();
+            run["text"] = decodeEntities(QString(text).replace(QRegExp("[ \\t\\r\\n\\f]+"), " "));
+
+            runs.append(run);
+        }
+
+        if (tagPosition < 0) {
+            break;
+        }
+
+        position = (tagPosition + tagExpression.matchedLength());
+
+        const QString name = tagExpression.cap(2).toLower();
+        const bool closing = !tagExpression.cap(1).isEmpty();
+
+        if (headTags.contains(name)) {
+            if (name == "head" || name == "title") {
+                head = !closing;
+            }
+
+            continue;
+        }
+
+        if (name == "br") {
+            if (skipDepth == 0) {
+                runs.append(lineBreak);
+            }
+
+            continue;
+        }
+
+        if (!blockTags.contains(name) && !inlineTags.contains(name)) {
+            return QString();
+        }
+
+        if (skipDepth > 0) {
+            skipDepth += (closing ? -1 : 1);
+
+            if (skipDepth > 0) {
+                continue;
+            }
+        }
+
+        if (closing) {
+            const int index = tags.lastIndexOf(name);
+
+            if (index < 0) {
+                continue;
+            }
+
+            while (tags.count() > index) {
+                tags.removeLast();
+                styles.removeLast();
+            }
+
+            if (blockTags.contains(name)) {
+                runs.append(lineBreak);
+            }
+
+            continue;
+        }
+
+        QHash<QString, QString> style = styles.last();
+        QString component;
+        QString options;
+
+        if (name == "b" || name == "strong") {
+            style["bold"] = "true";
+        } else if (name == "i" || name == "em") {
+            style["italic"] = "true";
+        } else if (name == "big") {
+            style["size"] = QString::number(style.value("size").toDouble() * 1.2);
+        } else if (name == "small") {
+            style["size"] = QString::number(style.value("size").toDouble() / 1.2);
+        }
+
+        const QString attributes = tagExpression.cap(3);
+        int attributePosition = 0;
+
+        while ((attributePosition = attributeExpression.indexIn(attributes, attributePosition)) >= 0) {
+            const QString attribute = attributeExpression.cap(1).toLower();
+            const QString value = decodeEntities(attributeExpression.cap(2) + attributeExpression.cap(3) + attributeExpression.cap(4));
+
+            attributePosition += attributeExpression.matchedLength();
+
+            if (attribute == "style") {
+                if (!parseStyle(value, style, (name == "body"))) {
+                    return QString();
+                }
+            } else if (attribute == "component") {
+                component = value;
+            } else if (attribute == "options") {
+                options = value;
+            } else if (attribute == "background" && name == "body") {
+                background = (value.toLower() == "true");
+            } else if (!allowedAttributes.contains(attribute)) {
+                return QString();
+            }
+        }
+
+        if (name == "body") {
+            if (style.contains("margin")) {
+                margin = style.take("margin");
+            }
+
+            if (style.contains("padding")) {
+                padding = style.take("padding");
+            }
+        }
+
+        if (blockTags.contains(name)) {
+            runs.append(lineBreak);
+        }
+
+        tags.append(name);
+        styles.append(style);
+
+        if (!component.isEmpty()) {
+            QHash<QString, QString> run = style;
+            run["component"] = component;
+
+            if (!options.isEmpty()) {
+                run["options"] = options;
+            }
+
+            runs.append(run);
+
+            skipDepth = 1;
+        }
+    }
+
+    runs.append(lineBreak);
+
+    QStringList lines;
+    QList<QHash<QString, QString> > line;
+    bool space = true;
+
+    for (int i = 0; i < runs.count(); ++i) {
+        QHash<QString, QString> run = runs.at(i);
+
+        if (!run.contains("break")) {
+            if (run.contains("text")) {
+                if (space && run["text"].startsWith(QLatin1Char(' '))) {
+                    run["text"].remove(0, 1);
+                }
+
+                if (run["text"].isEmpty()) {
+                    continue;
+                }
+
+                space = run["text"].endsWith(QLatin1Char(' '));
+            } else {
+                space = false;
+            }
+
+            line.append(run);
+
+            continue;
+        }
+
+        while (!line.isEmpty() && line.last().contains("text") && line.last()["text"].endsWith(QLatin1Char(' '))) {
+            line.last()["text"].chop(1);
+
+            if (line.last()["text"].isEmpty()) {
+                line.removeLast();
+            }
+        }
+
+        if (!line.isEmpty()) {
+            QString description = QString("<line align=\"%1\">").arg(Qt::escape(line.first().value("align")));
+
+            for (int j = 0; j < line.count(); ++j) {
+                QHash<QString, QString>::const_iterator iterator;
+
+                description.append(line.at(j).contains("component") ? QString("<component name=\"%1\"").arg(Qt::escape(line.at(j).value("component"))) : QString("<text"));
+
+                for (iterator = line.at(j).constBegin(); iterator != line.at(j).constEnd(); ++iterator) {
+                    if (iterator.key() != "text" && iterator.key() != "component" && iterator.key() != "align") {
+                        description.append(QString(" %1=\"%2\"").arg(iterator.key()).arg(Qt::escape(iterator.value())));
+                    }
+                }
+
+                description.append(line.at(j).contains("component") ? QString("/>") : QString(">%1</text>").arg(Qt::escape(line.at(j).value("text"))));
+            }
+
+            lines.append(description + "</line>");
+        }
+
+        line.clear();
+
+        space = true;
+    }
+
+    if (lines.isEmpty()) {
+        return QString();
+    }
+
+    const QStringList margins = margin.split(QLatin1Char(','));
+    const QStringList paddings = padding.split(QLatin1Char(','));
+    QStringList spacing;
+
+    for (int i = 0; i < 4; ++i) {
+        spacing.append(QString::number(margins.value(i).toDouble() + paddings.value(i).toDouble()));
+    }
+
+    return QString("<clock background=\"%1\" padding=\"%2\">%3</clock>").arg(background ? "true" : "false").arg(spacing.join(",")).arg(lines.join(QString()));
+}
+
+QString NativeTheme::decodeEntities(const QString &text)
+{
+    QString result = text;
+    QRegExp expression("&(#[xX][0-9a-fA-F]+|#\\d+|[a-zA-Z]+);");
+    int position = 0;
+
+    while ((position = expression.indexIn(result, position)) >= 0) {
+        const QString entity = expression.cap(1);
+        QString replacement = expression.cap(0);
+
+        if (entity.startsWith("#x", Qt::CaseInsensitive)) {
+            replacement = QChar(entity.mid(2).toUInt(NULL, 16));
+        } else if (entity.startsWith(QLatin1Char('#'))) {
+            replacement = QChar(entity.mid(1).toUInt());
+        } else if (entity == "amp") {
+            replacement = QLatin1String("&");
+        } else if (entity == "lt") {
+            replacement = QLatin1String("<");
+        } else if (entity == "gt") {
+            replacement = QLatin1String(">");
+        } else if (entity == "quot") {
+            replacement = QLatin1String("\"");
+        } else if (entity == "apos") {
+            replacement = QLatin1String("'");
+        } else if (entity == "nbsp") {
+            replacement = QChar(0xA0);
+        }
+
+        result.replace(position, expression.matchedLength(), replacement);
+
+        position += replacement.length();
+    }
+
+    return result;
+}
+
+qreal NativeTheme::parseLength(const QString &value, qreal base, bool *ok)
+{
+    QRegExp expression("(-?\\d*\\.?\\d+)(px|pt|em|%)?");
+
+    *ok = expression.exactMatch(value.trimmed().toLower());
+
+    if (!*ok) {
+        return 0;
+    }
+
+    const qreal length = expression.cap(1).toDouble();
+
+    if (expression.cap(2) == "em") {
+        return (length * base);
+    }
+
+    if (expression.cap(2) == "%") {
+        return ((length * base) / 100);
+    }
+
+    if (expression.cap(2) == "pt") {
+        return ((length * 4) / 3);
+    }
+
+    return length;
+}
+
+bool NativeTheme::parseStyle(const QString &style, QHash<QString, QString> &attributes, bool root)
+{
+    const QStringList declarations = style.split(QLatin1Char(';'), QString::SkipEmptyParts);
+
+    for (int i = 0; i < declarations.count(); ++i) {
+        const int separator = declarations.at(i).indexOf(QLatin1Char(':'));
+
+        if (separator < 0) {
+            if (declarations.at(i).trimmed().isEmpty()) {
+                continue;
+            }
+
+            return false;
+        }
+
+        const QString property = declarations.at(i).left(separator).trimmed().toLower();
+        const QString value = declarations.at(i).mid(separator + 1).trimmed().toLower();
+        bool ok = true;
+
+        if (property == "text-align") {
+            if (value != "left" && value != "center" && value != "right") {
+                return false;
+            }
+
+            attributes["align"] = value;
+        } else if (property == "font-size") {
+            const qreal base = attributes.value("size", "16").toDouble();
+            const qreal size = ((value == "larger") ? (base * 1.2) : ((value == "smaller") ? (base / 1.2) : parseLength(value, base, &ok)));
+
+            if (!ok || size <= 0) {
+                return false;
+            }
+
+            attributes["size"] = QString::number(size);
+        } else if (property == "font-weight") {
+            if (value == "bold" || value == "bolder" || value.toInt() >= 600) {
+                attributes["bold"] = "true";
+            } else if (value == "normal" || value == "lighter" || value.toInt() > 0) {
+                attributes["bold"] = "false";
+            } else {
+                return false;
+            }
+        } else if (property == "font-style") {
+            if (value != "normal" && value != "italic" && value != "oblique") {
+                return false;
+            }
+
+            attributes["italic"] = ((value == "normal") ? "false" : "true");
+        } else if (property == "font-family") {
+            const QString family = declarations.at(i).mid(separator + 1).split(QLatin1Char(',')).first().remove(QLatin1Char('"')).remove(QLatin1Char('\'')).trimmed();
+
+            if (family.isEmpty()) {
+                return false;
+            }
+
+            attributes["font"] = family;
+        } else if (property == "color") {
+            QRegExp expression("rgb\\(\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)\\s*\\)");
+            const QColor color = (expression.exactMatch(value) ? QColor(expression.cap(1).toInt(), expression.cap(2).toInt(), expression.cap(3).toInt()) : QColor(value));
+
+            if (!color.isValid()) {
+                return false;
+            }
+
+            attributes["color"] = color.name();
+        } else if (property == "opacity") {
+            const qreal opacity = value.toDouble(&ok);
+
+            if (!ok) {
+                return false;
+            }
+
+            attributes["opacity"] = QString::number(attributes.value("opacity", "1").toDouble() * qBound(qreal(0), opacity, qreal(1)));
+        } else if ((property == "margin" || property == "padding") && root) {
+            const QStringList values = value.split(QRegExp("\\s+"), QString::SkipEmptyParts);
+            QList<qreal> lengths;
+
+            for (int j = 0; j < values.count(); ++j) {
+                lengths.append(parseLength(values.at(j), attributes.value("size", "16").toDouble(), &ok));
+
+                if (!ok) {
+                    return false;
+                }
+            }
+
+            if (lengths.isEmpty() || lengths.count() > 4) {
+                return false;
+            }
+
+            while (lengths.count() < 4) {
+                lengths.append(lengths.at((lengths.count() == 3) ? 1 : 0));
+            }
+
+            QStringList spacing;
+
+            for (int j = 0; j < 4; ++j) {
+                spacing.append(QString::number(lengths.at(j)));
+            }
+
+            attributes[property] = spacing.join(",");
+        } else if (property != "white-space") {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
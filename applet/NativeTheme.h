@@ -0,0 +1,108 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#ifndef ADJUSTABLECLOCKNATIVETHEME_HEADER
+#define ADJUSTABLECLOCKNATIVETHEME_HEADER
+
+#include "DataSource.h"
+#include "GlyphAtlas.h"
+
+#include <QtCore/QXmlStreamReader>
+#include <QtGui/QFont>
+#include <QtGui/QColor>
+#include <QtGui/QPainter>
+#include <QtGui/QStaticText>
+
+namespace AdjustableClock
+{
+
+struct NativeRun
+{
+    ClockComponent component;
+    QString text;
+    ComponentOptions options;
+    QHash<QString, QString> attributes;
+    QStringList visibility;
+    QStaticText staticText;
+    GlyphStyle glyph;
+    QFont font;
+    QColor color;
+    QPointF offset;
+    QSizeF size;
+    qreal opacity;
+    qreal ascent;
+    int digit;
+    int state;
+    bool visible;
+};
+
+struct NativeLine
+{
+    QList<NativeRun> runs;
+    QHash<QString, QString> attributes;
+    QStringList visibility;
+    QRectF rectangle;
+    qreal ascent;
+    bool visible;
+};
+
+class Clock;
+
+class ADJUSTABLECLOCK_EXPORT NativeTheme : public QObject
+{
+    Q_OBJECT
+
+    public:
+        explicit NativeTheme(Clock *clock, QObject *parent = NULL);
+
+        bool setDescription(const QString &description);
+        void updateOptions();
+        bool updateComponent(ClockComponent component);
+        void paint(QPainter *painter, const QRectF &rectangle);
+        QSizeF getSize() const;
+        bool getBackgroundFlag() const;
+        static QString fromHtml(const QString &html);
+
+    protected:
+        void parseLine(QXmlStreamReader &reader, NativeLine &line, const QHash<QString, QString> &attributes, const QStringList &visibility);
+        void updateStyle(NativeRun &run);
+        void updateLayout();
+        void paintContents(QPainter *painter, qreal scale);
+        bool updateText(NativeRun &run);
+        bool isVisible(const QStringList &visibility) const;
+        QVariant resolve(const QString &expression, const QVariant &defaultValue) const;
+        static QHash<QString, QString> getAttributes(const QXmlStreamReader &reader, const QHash<QString, QString> &inherited);
+        static QString decodeEntities(const QString &text);
+        static qreal parseLength(const QString &value, qreal base, bool *ok);
+        static bool parseStyle(const QString &style, QHash<QString, QString> &attributes, bool root);
+
+    private:
+        Clock *m_clock;
+        QList<NativeLine> m_lines;
+        QHash<QString, QString> m_attributes;
+        QSizeF m_size;
+        QRectF m_contents;
+        qreal m_reflection;
+        bool m_background;
+};
+
+}
+
+#endif
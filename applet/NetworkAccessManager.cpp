@@ -0,0 +1,123 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#include "NetworkAccessManager.h"
+#include "Clock.h"
+
+#include <QtCore/QDir>
+
+#include <Plasma/Theme>
+
+namespace AdjustableClock
+{
+
+NetworkReply::NetworkReply(const QNetworkRequest &request, const Asset &asset, QObject *parent) : QNetworkReply(parent),
+    m_data(asset.data),
+    m_offset(0)
+{
+    setRequest(request);
+    setUrl(request.url());
+    setOperation(QNetworkAccessManager::GetOperation);
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+    if (asset.mimeType.isEmpty()) {
+        setError(QNetworkReply::ContentNotFoundError, QString("Resource not found: %1").arg(request.url().toString()));
+
+        QMetaObject::invokeMethod(this, "error", Qt::QueuedConnection, Q_ARG(QNetworkReply::NetworkError, QNetworkReply::ContentNotFoundError));
+    } else {
+        setHeader(QNetworkRequest::ContentTypeHeader, asset.mimeType);
+        setHeader(QNetworkRequest::ContentLengthHeader, m_data.size());
+
+        QMetaObject::invokeMethod(this, "metaDataChanged", Qt::QueuedConnection);
+        QMetaObject::invokeMethod(this, "readyRead", Qt::QueuedConnection);
+    }
+
+    QMetaObject::invokeMethod(this, "finished", Qt::QueuedConnection);
+}
+
+void NetworkReply::abort()
+{
+    close();
+}
+
+qint64 NetworkReply::bytesAvailable() const
+{
+    return ((m_data.size() - m_offset) + QNetworkReply::bytesAvailable());
+}
+
+bool NetworkReply::isSequential() const
+{
+    return true;
+}
+
+qint64 NetworkReply::readData(char *data, qint64 maxSize)
+{
+    if (m_offset >= m_data.size()) {
+        return -1;
+    }
+
+    const qint64 size = qMin(maxSize, (m_data.size() - m_offset));
+
+    qMemCopy(data, (m_data.constData() + m_offset), size);
+
+    m_offset += size;
+
+    return size;
+}
+
+NetworkAccessManager::NetworkAccessManager(Clock *clock, QObject *parent) : QNetworkAccessManager(parent),
+    m_clock(clock)
+{
+}
+
+QNetworkReply* NetworkAccessManager::createRequest(Operation operation, const QNetworkRequest &request, QIODevice *outgoingData)
+{
+    if (request.url().scheme() != "clock" || operation != GetOperation) {
+        return QNetworkAccessManager::createRequest(operation, request, outgoingData);
+    }
+
+    return new NetworkReply(request, getAsset(request.url()), this);
+}
+
+Asset NetworkAccessManager::getAsset(const QUrl &url) const
+{
+    const QString host = url.host();
+    const QString path = url.path();
+
+    if (host == "icon") {
+        return AssetCache::getInstance()->getIcon(path.section(QLatin1Char('/'), 2), path.section(QLatin1Char('/'), 1, 1).toInt());
+    }
+
+    if (host == "image") {
+        return AssetCache::getInstance()->getFile(Plasma::Theme::defaultTheme()->imagePath(path.mid(1)));
+    }
+
+    if (host == "theme") {
+        return AssetCache::getInstance()->getFile(QDir(m_clock->getPath()).absoluteFilePath(path.mid(1)));
+    }
+
+    if (host == "file") {
+        return AssetCache::getInstance()->getFile(path);
+    }
+
+    return Asset();
+}
+
+}
@@ -0,0 +1,70 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#ifndef ADJUSTABLECLOCKNETWORKACCESSMANAGER_HEADER
+#define ADJUSTABLECLOCKNETWORKACCESSMANAGER_HEADER
+
+#include "AssetCache.h"
+
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkAccessManager>
+
+namespace AdjustableClock
+{
+
+class Clock;
+
+class NetworkReply : public QNetworkReply
+{
+    Q_OBJECT
+
+    public:
+        explicit NetworkReply(const QNetworkRequest &request, const Asset &asset, QObject *parent = NULL);
+
+        void abort();
+        qint64 bytesAvailable() const;
+        bool isSequential() const;
+
+    protected:
+        qint64 readData(char *data, qint64 maxSize);
+
+    private:
+        QByteArray m_data;
+        qint64 m_offset;
+};
+
+class NetworkAccessManager : public QNetworkAccessManager
+{
+    Q_OBJECT
+
+    public:
+        explicit NetworkAccessManager(Clock *clock, QObject *parent = NULL);
+
+    protected:
+        QNetworkReply* createRequest(Operation operation, const QNetworkRequest &request, QIODevice *outgoingData = NULL);
+        Asset getAsset(const QUrl &url) const;
+
+    private:
+        Clock *m_clock;
+};
+
+}
+
+#endif
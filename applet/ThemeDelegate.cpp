@@ -23,6 +23,7 @@
 #include "ThemeWidget.h"
 #include "Configuration.h"
 
+#include <QtCore/QTimer>
 #include <QtGui/QStyle>
 #include <QtGui/QPainter>
 #include <QtGui/QBoxLayout>
@@ -41,14 +42,22 @@ namespace AdjustableClock
 KPixmapCache *m_cache = NULL;
 
 ThemeDelegate::ThemeDelegate(Clock *clock) : QStyledItemDelegate(clock),
-    m_clock(clock)
+    m_clock(clock),
+    m_scene(NULL),
+    m_widget(NULL),
+    m_queueTimer(new QTimer(this))
 {
     m_cache = new KPixmapCache("AdjustableClockPreviews");
     m_cache->discard();
+
+    m_queueTimer->setSingleShot(true);
+
+    connect(m_queueTimer, SIGNAL(timeout()), this, SLOT(renderNext()));
 }
 
 ThemeDelegate::~ThemeDelegate()
 {
+    delete m_scene;
     delete m_cache;
 }
 
@@ -59,44 +68,35 @@ void ThemeDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
     QPixmap pixmap;
 
     if (!m_cache->find((index.data(IdentifierRole).toString()), pixmap)) {
-        pixmap = QPixmap(200, 100);
-        pixmap.fill(Qt::transparent);
-
-        QRectF rectangle(0, 0, 200, 100);
-        QPainter pixmapPainter(&pixmap);
-        pixmapPainter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
-
-        QGraphicsScene scene;
-        ThemeWidget widget(m_clock);
-        widget.setTheme(index.data(PathRole).toString());
-
-        if (widget.getBackgroundFlag()) {
-            Plasma::FrameSvg background;
-            background.setImagePath(Plasma::Theme::defaultTheme()->imagePath("widgets/background"));
-            background.setEnabledBorders(Plasma::FrameSvg::AllBorders);
-            background.resizeFrame(rectangle.size());
-            background.paintFrame(&pixmapPainter);
-
-            rectangle = background.contentsRect();
-        } else {
-            pixmapPainter.setOpacity(0.1);
-            pixmapPainter.setBrush(QBrush(Plasma::Theme::defaultTheme()->color(Plasma::Theme::BackgroundColor)));
-            pixmapPainter.setPen(QPen(Qt::transparent));
-            pixmapPainter.drawRoundedRect(rectangle.toRect(), 10, 10);
-            pixmapPainter.setOpacity(1);
+        const QStyleOptionViewItemV4 *optionV4 = qstyleoption_cast<const QStyleOptionViewItemV4*>(&option);
+
+        if (optionV4 && !m_view) {
+            m_view = qobject_cast<QAbstractItemView*>(const_cast<QWidget*>(optionV4->widget));
         }
 
-        widget.resize(rectangle.size());
+        if (!m_queue.contains(QPersistentModelIndex(index))) {
+            m_queue.append(QPersistentModelIndex(index));
+        }
 
-        scene.addItem(&widget);
-        scene.render(&pixmapPainter, rectangle);
+        if (!m_queueTimer->isActive()) {
+            m_queueTimer->start(0);
+        }
 
-        m_cache->insert((index.data(IdentifierRole).toString()), pixmap);
+        painter->save();
+        painter->setRenderHints(QPainter::Antialiasing);
+        painter->setOpacity(0.1);
+        painter->setBrush(QBrush(Plasma::Theme::defaultTheme()->color(Plasma::Theme::BackgroundColor)));
+        painter->setPen(QPen(Qt::transparent));
+        painter->drawRoundedRect(QRect(option.rect.topLeft(), QSize(200, 100)), 10, 10);
+        painter->restore();
     }
 
     QFont font = painter->font();
 
-    painter->drawPixmap(option.rect.topLeft(), pixmap);
+    if (!pixmap.isNull()) {
+        painter->drawPixmap(option.rect.topLeft(), pixmap);
+    }
+
     painter->setRenderHints(QPainter::TextAntialiasing);
     painter->setPen(option.palette.color(QPalette::WindowText));
 
@@ -111,9 +111,99 @@ void ThemeDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
     painter->drawText(QRectF(210, (option.rect.y() + 35), (option.rect.width() - 215), 70), (Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap), index.data(DescriptionRole).toString());
 }
 
+QPixmap ThemeDelegate::renderPreview(const QString &path)
+{
+    if (!m_scene) {
+        m_scene = new QGraphicsScene();
+        m_widget = new ThemeWidget(m_clock);
+
+        m_scene->addItem(m_widget);
+    }
+
+    QPixmap pixmap(200, 100);
+    pixmap.fill(Qt::transparent);
+
+    QRectF rectangle(0, 0, 200, 100);
+    QPainter pixmapPainter(&pixmap);
+    pixmapPainter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
+
+    m_widget->setTheme(path);
+
+    if (m_widget->getBackgroundFlag()) {
+        Plasma::FrameSvg background;
+        background.setImagePath(Plasma::Theme::defaultTheme()->imagePath("widgets/background"));
+        background.setEnabledBorders(Plasma::FrameSvg::AllBorders);
+        background.resizeFrame(rectangle.size());
+        background.paintFrame(&pixmapPainter);
+
+        rectangle = background.contentsRect();
+    } else {
+        pixmapPainter.setOpacity(0.1);
+        pixmapPainter.setBrush(QBrush(Plasma::Theme::defaultTheme()->color(Plasma::Theme::BackgroundColor)));
+        pixmapPainter.setPen(QPen(Qt::transparent));
+        pixmapPainter.drawRoundedRect(rectangle.toRect(), 10, 10);
+        pixmapPainter.setOpacity(1);
+    }
+
+    m_widget->resize(rectangle.size());
+
+    m_scene->render(&pixmapPainter, rectangle, m_widget->boundingRect());
+
+    return pixmap;
+}
+
+void ThemeDelegate::renderNext()
+{
+    int position = -1;
+
+    for (int i = (m_queue.count() - 1); i >= 0; --i) {
+        if (!m_queue.at(i).isValid()) {
+            m_queue.removeAt(i);
+        }
+    }
+
+    for (int i = 0; i < m_queue.count(); ++i) {
+        if (m_view && m_view->viewport()->rect().intersects(m_view->visualRect(m_queue.at(i)))) {
+            position = i;
+
+            break;
+        }
+    }
+
+    if (position < 0) {
+        if (m_queue.isEmpty()) {
+            delete m_scene;
+
+            m_scene = NULL;
+            m_widget = NULL;
+
+            return;
+        }
+
+        position = 0;
+    }
+
+    const QPersistentModelIndex index = m_queue.takeAt(position);
+    QPixmap pixmap;
+
+    if (!m_cache->find(index.data(IdentifierRole).toString(), pixmap)) {
+        m_cache->insert(index.data(IdentifierRole).toString(), renderPreview(index.data(PathRole).toString()));
+    }
+
+    if (m_view) {
+        m_view->update(index);
+    }
+
+    m_queueTimer->start(0);
+}
+
 void ThemeDelegate::clear()
 {
     m_cache->discard();
+
+    if (m_view) {
+        m_view->viewport()->update();
+    }
 }
 
 void ThemeDelegate::propagateSignal()
@@ -146,7 +236,7 @@ QWidget* ThemeDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem
     QBoxLayout *layout = new QBoxLayout(QBoxLayout::LeftToRight, widget);
     layout->addItem(new QSpacerItem(0, 0, QSizePolicy::Expanding, QSizePolicy::Expanding));
 
-    if (QFile::exists(index.data(PathRole).toString() + "/contents/config/main.xml")) {
+    if (index.data(ConfigurableRole).toBool()) {
         QPushButton *optionsButton = new QPushButton(KIcon("configure"), QString(), widget);
         optionsButton->setToolTip(i18n("Options..."));
         optionsButton->setObjectName("options-" + index.data(IdentifierRole).toString());
@@ -21,12 +21,18 @@
 #ifndef ADJUSTABLECLOCKTHEMEDELEGATE_HEADER
 #define ADJUSTABLECLOCKTHEMEDELEGATE_HEADER
 
+#include <QtCore/QPointer>
+#include <QtGui/QAbstractItemView>
 #include <QtGui/QStyledItemDelegate>
 
+class QTimer;
+class QGraphicsScene;
+
 namespace AdjustableClock
 {
 
 class Clock;
+class ThemeWidget;
 
 class ThemeDelegate : public QStyledItemDelegate
 {
@@ -44,11 +50,20 @@ class ThemeDelegate : public QStyledItemDelegate
     public slots:
         void clear();
 
+    protected:
+        QPixmap renderPreview(const QString &path);
+
     protected slots:
         void propagateSignal();
+        void renderNext();
 
     private:
         Clock *m_clock;
+        QGraphicsScene *m_scene;
+        ThemeWidget *m_widget;
+        QTimer *m_queueTimer;
+        mutable QList<QPersistentModelIndex> m_queue;
+        mutable QPointer<QAbstractItemView> m_view;
 
     signals:
         void showAbout(QString theme);
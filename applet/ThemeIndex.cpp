@@ -0,0 +1,216 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#include "ThemeIndex.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QDateTime>
+#include <QtCore/QCoreApplication>
+
+#include <KConfig>
+#include <KDirWatch>
+#include <KConfigGroup>
+#include <KStandardDirs>
+
+#include <Plasma/PackageMetadata>
+
+namespace AdjustableClock
+{
+
+ThemeIndex* ThemeIndex::m_instance = NULL;
+
+ThemeIndex::ThemeIndex(QObject *parent) : QObject(parent),
+    m_watcher(new KDirWatch(this)),
+    m_indexPath(KStandardDirs::locateLocal("cache", "adjustableclock/themes.index"))
+{
+    KStandardDirs::locateLocal("data", "plasma/adjustableclock/");
+
+    m_locations = KGlobal::dirs()->findDirs("data", "plasma/adjustableclock");
+
+    for (int i = 0; i < m_locations.count(); ++i) {
+        m_watcher->addDir(m_locations.at(i), (KDirWatch::WatchSubDirs | KDirWatch::WatchFiles));
+    }
+
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(500);
+
+    connect(m_watcher, SIGNAL(dirty(QString)), &m_updateTimer, SLOT(start()));
+    connect(m_watcher, SIGNAL(created(QString)), &m_updateTimer, SLOT(start()));
+    connect(m_watcher, SIGNAL(deleted(QString)), &m_updateTimer, SLOT(start()));
+    connect(&m_updateTimer, SIGNAL(timeout()), this, SLOT(update()));
+
+    load();
+    update();
+}
+
+ThemeIndex* ThemeIndex::getInstance()
+{
+    if (!m_instance) {
+        m_instance = new ThemeIndex(QCoreApplication::instance());
+    }
+
+    return m_instance;
+}
+
+void ThemeIndex::load()
+{
+    KConfig index(m_indexPath, KConfig::SimpleConfig);
+    const QStringList identifiers = index.groupList();
+
+    for (int i = 0; i < identifiers.count(); ++i) {
+        const KConfigGroup group(&index, identifiers.at(i));
+        ThemeInfo theme;
+        theme.identifier = identifiers.at(i);
+        theme.path = group.readEntry("Path", QString());
+        theme.name = group.readEntry("Name", QString());
+        theme.description = group.readEntry("Description", QString());
+        theme.author = group.readEntry("Author", QString());
+        theme.type = static_cast<ThemeType>(group.readEntry("Type", static_cast<int>(UnknownType)));
+        theme.modified = group.readEntry("Modified", 0U);
+        theme.configuration = group.readEntry("Configuration", false);
+        theme.editable = group.readEntry("Editable", false);
+
+        m_themes[theme.identifier] = theme;
+    }
+}
+
+void ThemeIndex::save()
+{
+    KConfig index(m_indexPath, KConfig::SimpleConfig);
+    const QStringList identifiers = index.groupList();
+
+    for (int i = 0; i < identifiers.count(); ++i) {
+        index.deleteGroup(identifiers.at(i));
+    }
+
+    QHash<QString, ThemeInfo>::const_iterator iterator;
+
+    for (iterator = m_themes.constBegin(); iterator != m_themes.constEnd(); ++iterator) {
+        KConfigGroup group(&index, iterator.key());
+        group.writeEntry("Path", iterator.value().path);
+        group.writeEntry("Name", iterator.value().name);
+        group.writeEntry("Description", iterator.value().description);
+        group.writeEntry("Author", iterator.value().author);
+        group.writeEntry("Type", static_cast<int>(iterator.value().type));
+        group.writeEntry("Modified", iterator.value().modified);
+        group.writeEntry("Configuration", iterator.value().configuration);
+        group.writeEntry("Editable", iterator.value().editable);
+    }
+
+    index.sync();
+}
+
+void ThemeIndex::update()
+{
+    QHash<QString, ThemeInfo> themes;
+    bool changed = false;
+
+    for (int i = 0; i < m_locations.count(); ++i) {
+        const QDir location(m_locations.at(i));
+        const QStringList entries = location.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+
+        for (int j = 0; j < entries.count(); ++j) {
+            const QString path = location.absoluteFilePath(entries.at(j));
+
+            if (themes.contains(entries.at(j)) || !QFile::exists(path + "/metadata.desktop")) {
+                continue;
+            }
+
+            if (m_themes.contains(entries.at(j)) && m_themes[entries.at(j)].path == QFileInfo(path).canonicalFilePath() && m_themes[entries.at(j)].modified == getModificationTime(path)) {
+                themes[entries.at(j)] = m_themes[entries.at(j)];
+            } else {
+                themes[entries.at(j)] = readTheme(path);
+
+                changed = true;
+            }
+        }
+    }
+
+    if (!changed && themes.count() == m_themes.count()) {
+        return;
+    }
+
+    m_themes = themes;
+
+    save();
+
+    emit themesChanged();
+}
+
+ThemeInfo ThemeIndex::readTheme(const QString &path)
+{
+    const Plasma::PackageMetadata metaData(path + "/metadata.desktop");
+    ThemeInfo theme;
+    theme.identifier = QFileInfo(path).fileName();
+    theme.path = QFileInfo(path).canonicalFilePath();
+    theme.name = metaData.name();
+    theme.description = metaData.description();
+    theme.author = metaData.author();
+    theme.type = (QFile::exists(path + "/contents/ui/main.qml") ? QmlType : (QFile::exists(path + "/contents/ui/main.xml") ? NativeType : HtmlType));
+    theme.modified = getModificationTime(path);
+    theme.configuration = QFile::exists(path + "/contents/config/main.xml");
+    theme.editable = QFileInfo(path).isWritable();
+
+    return theme;
+}
+
+uint ThemeIndex::getModificationTime(const QString &path)
+{
+    const QStringList entries = (QStringList() << path << (path + "/metadata.desktop") << (path + "/contents/ui") << (path + "/contents/config"));
+    uint modified = 0;
+
+    for (int i = 0; i < entries.count(); ++i) {
+        const QFileInfo fileInfo(entries.at(i));
+
+        if (fileInfo.exists()) {
+            modified = qMax(modified, fileInfo.lastModified().toTime_t());
+        }
+    }
+
+    return modified;
+}
+
+ThemeInfo ThemeIndex::getTheme(const QString &identifier) const
+{
+    if (m_themes.contains(identifier)) {
+        return m_themes[identifier];
+    }
+
+    ThemeInfo theme;
+    theme.type = UnknownType;
+    theme.modified = 0;
+    theme.configuration = false;
+    theme.editable = false;
+
+    return theme;
+}
+
+QList<ThemeInfo> ThemeIndex::getThemes() const
+{
+    return m_themes.values();
+}
+
+bool ThemeIndex::hasTheme(const QString &identifier) const
+{
+    return m_themes.contains(identifier);
+}
+
+}
@@ -0,0 +1,83 @@
+/***********************************************************************************
+* Adjustable Clock: Plasmoid to show date and time in adjustable format.
+* Copyright (C) 2008 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+#ifndef ADJUSTABLECLOCKTHEMEINDEX_HEADER
+#define ADJUSTABLECLOCKTHEMEINDEX_HEADER
+
+#include "Clock.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QTimer>
+
+class KDirWatch;
+
+namespace AdjustableClock
+{
+
+struct ThemeInfo
+{
+    QString identifier;
+    QString path;
+    QString name;
+    QString description;
+    QString author;
+    ThemeType type;
+    uint modified;
+    bool configuration;
+    bool editable;
+};
+
+class ADJUSTABLECLOCK_EXPORT ThemeIndex : public QObject
+{
+    Q_OBJECT
+
+    public:
+        static ThemeIndex* getInstance();
+        ThemeInfo getTheme(const QString &identifier) const;
+        QList<ThemeInfo> getThemes() const;
+        bool hasTheme(const QString &identifier) const;
+
+    public slots:
+        void update();
+
+    protected:
+        explicit ThemeIndex(QObject *parent = NULL);
+
+        void load();
+        void save();
+        static ThemeInfo readTheme(const QString &path);
+        static uint getModificationTime(const QString &path);
+
+    private:
+        KDirWatch *m_watcher;
+        QTimer m_updateTimer;
+        QStringList m_locations;
+        QHash<QString, ThemeInfo> m_themes;
+        QString m_indexPath;
+
+        static ThemeIndex *m_instance;
+
+    signals:
+        void themesChanged();
+};
+
+}
+
+#endif
@@ -19,15 +19,25 @@
 ***********************************************************************************/
 
 #include "ThemeWidget.h"
+#include "NativeTheme.h"
+#include "ClockContext.h"
+#include "ImageProvider.h"
+#include "NetworkAccessManager.h"
+#include "ThemePage.h"
 #include "Applet.h"
 
 #include <QtGui/QPainter>
+#include <QtGui/QFontMetricsF>
 #include <QtGui/QDesktopServices>
 #include <QtGui/QGraphicsSceneMouseEvent>
+#include <QtCore/QFile>
 #include <QtCore/QTextStream>
-#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
 #include <QtWebKit/QWebFrame>
 #include <QtWebKit/QWebElement>
+#include <QtWebKit/QWebSecurityOrigin>
+#include <QtDeclarative/QDeclarativeEngine>
+#include <QtDeclarative/QDeclarativeContext>
 
 #include <Plasma/Theme>
 
@@ -37,22 +47,42 @@ namespace AdjustableClock
 ThemeWidget::ThemeWidget(Clock *clock, Applet *parent) : Plasma::DeclarativeWidget(parent),
     m_applet(parent),
     m_clock(clock),
-    m_rootObject(NULL)
+    m_rootObject(NULL),
+    m_page(NULL),
+    m_manager(NULL),
+    m_native(NULL),
+    m_context(NULL),
+    m_speculationPage(NULL),
+    m_frameRate(0),
+    m_frameOverruns(0),
+    m_scriptOverruns(0),
+    m_tickBudget(100),
+    m_loading(false),
+    m_throttled(false),
+    m_framePending(false),
+    m_frameDirty(false),
+    m_snapshotPending(false),
+    m_snapshotReplaced(false)
 {
-    QPalette palette = m_page.palette();
-    palette.setBrush(QPalette::Base, Qt::transparent);
-
-    m_page.setPalette(palette);
-    m_page.settings()->setFontFamily(QWebSettings::StandardFont, "sans");
+    setInitializationDelayed(parent != NULL);
 
     connect(m_clock, SIGNAL(componentChanged(ClockComponent)), this, SLOT(updateComponent(ClockComponent)));
-    connect(&m_page, SIGNAL(repaintRequested(QRect)), this, SLOT(update()));
+    connect(m_clock, SIGNAL(frameRateChanged(int)), this, SLOT(setFrameRate(int)));
+    connect(this, SIGNAL(finished()), this, SLOT(finishLoading()));
+    m_speculationTimer.setSingleShot(true);
+    m_themeTimer.setSingleShot(true);
+    m_themeTimer.setInterval(100);
+
+    connect(&m_frameTimer, SIGNAL(timeout()), this, SLOT(updateFrame()));
+    connect(&m_speculationTimer, SIGNAL(timeout()), this, SLOT(prepareFrame()));
+    connect(&m_themeTimer, SIGNAL(timeout()), this, SLOT(updateTheme()));
 }
 
 void ThemeWidget::resizeEvent(QGraphicsSceneResizeEvent *event)
 {
     QGraphicsWidget::resizeEvent(event);
 
+    discardFrame();
     updateSize();
 }
 
@@ -60,22 +90,22 @@ void ThemeWidget::hoverMoveEvent(QGraphicsSceneHoverEvent *event)
 {
     const QPoint position = (event->pos() - m_offset).toPoint();
 
-    setCursor(m_page.mainFrame()->hitTestContent(position).linkUrl().isValid() ? Qt::PointingHandCursor : Qt::ArrowCursor);
+    setCursor(getPage()->mainFrame()->hitTestContent(position).linkUrl().isValid() ? Qt::PointingHandCursor : Qt::ArrowCursor);
 
     QMouseEvent mouseEvent(QEvent::MouseMove, position, Qt::NoButton, Qt::NoButton, Qt::NoModifier);
 
-    m_page.event(&mouseEvent);
+    getPage()->event(&mouseEvent);
 }
 
 void ThemeWidget::mousePressEvent(QGraphicsSceneMouseEvent *event)
 {
-    if (m_rootObject) {
+    if (m_rootObject || m_native || m_loading) {
         Plasma::DeclarativeWidget::mousePressEvent(event);
 
         return;
     }
 
-    const QUrl url = m_page.mainFrame()->hitTestContent((event->pos() - m_offset).toPoint()).linkUrl();
+    const QUrl url = getPage()->mainFrame()->hitTestContent((event->pos() - m_offset).toPoint()).linkUrl();
 
     if (url.isValid()) {
         QDesktopServices::openUrl(url);
@@ -91,25 +121,108 @@ void ThemeWidget::paint(QPainter *painter, const QStyleOptionGraphicsItem *optio
     Q_UNUSED(option)
     Q_UNUSED(widget)
 
+    paintTheme(painter);
+
+    if (m_framePending) {
+        m_framePending = false;
+
+        finishFrameTime();
+    }
+}
+
+void ThemeWidget::paintTheme(QPainter *painter)
+{
     painter->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
+
+    if (!m_snapshot.isNull()) {
+        if (!m_snapshotReplaced) {
+            const QSizeF size = QSizeF(m_snapshot.size()).scaled(boundingRect().size(), Qt::KeepAspectRatio);
+
+            painter->drawPixmap(QRectF(QPointF(((boundingRect().width() - size.width()) / 2), ((boundingRect().height() - size.height()) / 2)), size), m_snapshot, QRectF(m_snapshot.rect()));
+
+            if (m_snapshotPending) {
+                m_snapshotPending = false;
+
+                QTimer::singleShot(0, this, SIGNAL(snapshotPresented()));
+            }
+
+            return;
+        }
+
+        m_snapshot = QPixmap();
+        m_snapshotReplaced = false;
+    }
+
+    if (m_native) {
+        m_native->paint(painter, boundingRect());
+
+        return;
+    }
+
+    if (m_loading) {
+        const QString text = QString("%1:%2").arg(m_clock->getValue(HourComponent).toString()).arg(m_clock->getValue(MinuteComponent).toString());
+        QFont font = Plasma::Theme::defaultTheme()->font(Plasma::Theme::DefaultFont);
+        font.setPixelSize(100);
+
+        const QSizeF size = QFontMetricsF(font).size(Qt::TextSingleLine, text);
+
+        font.setPixelSize(qMax(1, qRound(80 * qMin((boundingRect().width() / size.width()), (boundingRect().height() / size.height())))));
+
+        painter->setFont(font);
+        painter->setPen(Plasma::Theme::defaultTheme()->color(Plasma::Theme::TextColor));
+        painter->drawText(boundingRect(), Qt::AlignCenter, text);
+
+        return;
+    }
+
+    if (!m_frame.isNull()) {
+        painter->drawPixmap(QPointF(0, 0), m_frame);
+
+        m_frame = QPixmap();
+
+        QTimer::singleShot(0, this, SLOT(update()));
+
+        return;
+    }
+
     painter->translate(m_offset);
 
-    m_page.mainFrame()->render(painter, QWebFrame::ContentsLayer);
+    getPage()->mainFrame()->render(painter, QWebFrame::ContentsLayer);
 }
 
 void ThemeWidget::clear()
 {
-    disconnect(Plasma::Theme::defaultTheme(), SIGNAL(themeChanged()), this, SLOT(updateTheme()));
+    disconnect(Plasma::Theme::defaultTheme(), SIGNAL(themeChanged()), &m_themeTimer, SLOT(start()));
 
     setAcceptHoverEvents(false);
     setAcceptedMouseButtons(Qt::LeftButton | Qt::MidButton | Qt::RightButton);
-    setFlag(QGraphicsItem::ItemHasNoContents, true);
+    setFlag(QGraphicsItem::ItemHasNoContents, m_snapshot.isNull());
+    setFrameRate(0);
 
-    m_page.mainFrame()->setHtml(QString());
+    m_speculationTimer.stop();
+    m_themeTimer.stop();
 
+    discardFrame();
+
+    m_frameOverruns = 0;
+    m_scriptOverruns = 0;
+    m_loading = false;
+    m_throttled = false;
+
+    if (m_page) {
+        m_page->mainFrame()->setHtml(QString());
+        m_page->settings()->setAttribute(QWebSettings::JavascriptEnabled, true);
+    }
+
+    m_html = QString();
     m_css = QString();
+    m_styleSheet = QString();
+
+    if (m_native) {
+        m_native->deleteLater();
 
-    m_objects.clear();
+        m_native = NULL;
+    }
 
     if (m_rootObject) {
         m_rootObject->deleteLater();
@@ -120,28 +233,95 @@ void ThemeWidget::clear()
 
 void ThemeWidget::update()
 {
+    m_frameDirty = true;
+
     Plasma::DeclarativeWidget::update();
 }
 
 void ThemeWidget::updateComponent(ClockComponent component)
 {
-    const QLatin1String componentString = Clock::getComponentString(component);
+    if (m_speculativeDateTime.isValid()) {
+        if (m_speculativeComponents.contains(component) && m_clock->getDateTime() == m_speculativeDateTime) {
+            if (!m_nextFrame.isNull()) {
+                m_frame = m_nextFrame;
+                m_nextFrame = QPixmap();
+            }
 
+            QTimer::singleShot(0, this, SLOT(finishFrame()));
+        } else {
+            discardFrame();
+        }
+    }
+
+    applyComponent(component);
+
+    if (component == SecondComponent && m_applet && !m_rootObject && !m_native && !m_loading) {
+        m_speculationTimer.start(100);
+    }
+}
+
+void ThemeWidget::applyComponent(ClockComponent component)
+{
     if (m_rootObject) {
-        const QList<QPointer<QObject> > objects = m_objects.value(component);
+        m_context->updateComponent(component);
+
+        return;
+    }
 
-        for (int i = 0; i < objects.count(); ++i) {
-            if (objects.at(i)) {
-                const QVariantMap options = objects.at(i)->property("adjustableClock").toMap();
+    if (m_loading) {
+        if (component == HourComponent || component == MinuteComponent) {
+            update();
+        }
 
-                objects.at(i)->setProperty(options.value("attribute", "text").toString().toLatin1(), getValue(componentString, options.value("options").toString()));
+        return;
+    }
+
+    if (m_native) {
+        const QSizeF size = m_native->getSize();
+
+        if (m_native->updateComponent(component)) {
+            if (m_native->getSize() != size) {
+                updateSize();
             }
+
+            update();
         }
 
         return;
     }
 
-    const QWebElementCollection elements = m_page.mainFrame()->findAllElements(QString("[component=%1]").arg(componentString));
+    const QLatin1String componentString = Clock::getComponentString(component);
+
+    applyElements(getPage()->mainFrame(), component);
+
+    if (m_throttled && Clock::getComponentGranularity(component) <= SecondGranularity) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    getPage()->mainFrame()->evaluateJavaScript(QString("Clock.sendEvent('Clock%1Changed')").arg(componentString));
+
+    const int time = timer.elapsed();
+
+    if (time > m_tickBudget) {
+        ++m_scriptOverruns;
+
+        emit scriptBudgetExceeded(time);
+
+        if (m_scriptOverruns >= 3 && !m_throttled) {
+            m_throttled = true;
+
+            setFrameRate(0);
+        }
+    }
+}
+
+void ThemeWidget::applyElements(QWebFrame *frame, ClockComponent component)
+{
+    const QLatin1String componentString = Clock::getComponentString(component);
+    const QWebElementCollection elements = frame->findAllElements(QString("[component=%1]").arg(componentString));
 
     for (int i = 0; i < elements.count(); ++i) {
         const QString value = getValue(componentString, elements.at(i).attribute("options"));
@@ -152,29 +332,90 @@ void ThemeWidget::updateComponent(ClockComponent component)
             elements.at(i).setInnerXml(value);
         }
     }
+}
 
-    m_page.mainFrame()->evaluateJavaScript(QString("Clock.sendEvent('Clock%1Changed')").arg(componentString));
+void ThemeWidget::disableScripts()
+{
+    ++m_scriptOverruns;
+
+    m_throttled = true;
+
+    setFrameRate(0);
+
+    if (m_page) {
+        m_page->settings()->setAttribute(QWebSettings::JavascriptEnabled, false);
+    }
+
+    emit scriptBudgetExceeded(-1);
 }
 
-void ThemeWidget::updateTheme()
+void ThemeWidget::applyComponents()
 {
-    m_page.mainFrame()->evaluateJavaScript(QString("Clock.setStyleSheet('%1'); Clock.sendEvent('ClockThemeChanged');").arg(Plasma::Theme::defaultTheme()->styleSheet().replace('\n', "\\n") + m_css));
+    const QWebElementCollection elements = getPage()->mainFrame()->findAllElements("[component]");
+
+    for (int i = 0; i < elements.count(); ++i) {
+        const QString component = elements.at(i).attribute("component");
+
+        if (Clock::getComponent(component) == InvalidComponent) {
+            continue;
+        }
+
+        const QString value = getValue(component, elements.at(i).attribute("options"));
+
+        if (elements.at(i).hasAttribute("attribute")) {
+            elements.at(i).setAttribute(elements.at(i).attribute("attribute"), value);
+        } else {
+            elements.at(i).setInnerXml(value);
+        }
+    }
+
+    QString script("Clock.sendEvent('ClockOptionsChanged');");
+
+    for (int i = 1; i < LastComponent; ++i) {
+        script.append(QString("Clock.sendEvent('Clock%1Changed');").arg(Clock::getComponentString(static_cast<ClockComponent>(i))));
+    }
+
+    getPage()->mainFrame()->evaluateJavaScript(script);
 }
 
-void ThemeWidget::updateSize()
+void ThemeWidget::updateTheme()
 {
-    if (m_applet) {
-        QSizeF size;
+    discardFrame();
 
-        if (m_applet->formFactor() == Plasma::Horizontal) {
-            size.setWidth(m_size.width() * (m_applet->boundingRect().height() / m_size.height()));
-        } else if (m_applet->formFactor() == Plasma::Vertical) {
-            size.setHeight(m_size.height() * (m_applet->boundingRect().width() / m_size.width()));
+    if (m_native) {
+        if (!m_html.isEmpty()) {
+            m_native->setDescription(NativeTheme::fromHtml(m_html));
         }
 
-        setMinimumSize(size);
+        m_native->updateOptions();
+
+        updateSize();
+        update();
+
+        return;
+    }
+
+    const QString styleSheet = (QLatin1String("html, body {margin: 0; padding: 0;} ") + Plasma::Theme::defaultTheme()->styleSheet() + m_css);
+
+    QString script;
+
+    if (styleSheet != m_styleSheet) {
+        m_styleSheet = styleSheet;
+
+        script = QString("Clock.setStyleSheet('%1');").arg(QString(styleSheet).replace('\\', "\\\\").replace('\'', "\\'").replace('\n', "\\n").remove('\r'));
+    }
+
+    getPage()->mainFrame()->evaluateJavaScript(script + "Clock.sendEvent('ClockThemeChanged');");
+}
+
+void ThemeWidget::updateSize()
+{
+    if (m_native) {
+        m_size = m_native->getSize().toSize();
     }
 
+    updateMinimumSize();
+
     const QSizeF constraints = boundingRect().size();
 
     if (m_rootObject) {
@@ -184,8 +425,13 @@ void ThemeWidget::updateSize()
         return;
     }
 
+    if (m_native || m_loading) {
+        return;
+    }
+
     QWebPage page;
-    page.mainFrame()->setHtml(m_page.mainFrame()->toHtml());
+    page.setNetworkAccessManager(m_manager);
+    page.mainFrame()->setHtml(getPage()->mainFrame()->toHtml(), QUrl("clock://theme/"));
     page.setViewportSize(QSize(0, 0));
 
     const QSize size = page.mainFrame()->contentsSize();
@@ -194,19 +440,230 @@ void ThemeWidget::updateSize()
 
     page.mainFrame()->setZoomFactor((widthFactor > heightFactor) ? heightFactor : widthFactor);
 
-    disconnect(m_page.mainFrame(), SIGNAL(contentsSizeChanged(QSize)), this, SLOT(updateSize()));
+    disconnect(m_page->mainFrame(), SIGNAL(contentsSizeChanged(QSize)), this, SLOT(updateSize()));
 
-    m_page.setViewportSize(page.mainFrame()->contentsSize());
-    m_page.mainFrame()->setZoomFactor(page.mainFrame()->zoomFactor());
+    m_page->setViewportSize(page.mainFrame()->contentsSize());
+    m_page->mainFrame()->setZoomFactor(page.mainFrame()->zoomFactor());
 
     m_size = size;
-    m_offset = QPointF(((constraints.width() - m_page.viewportSize().width()) / 2), ((constraints.height() - m_page.viewportSize().height()) / 2));
+    m_offset = QPointF(((constraints.width() - m_page->viewportSize().width()) / 2), ((constraints.height() - m_page->viewportSize().height()) / 2));
+
+    connect(m_page->mainFrame(), SIGNAL(contentsSizeChanged(QSize)), this, SLOT(updateSize()));
+}
+
+void ThemeWidget::updateMinimumSize()
+{
+    if (!m_applet || m_size.isEmpty()) {
+        return;
+    }
+
+    QSizeF size;
+
+    if (m_applet->formFactor() == Plasma::Horizontal) {
+        size.setWidth(m_size.width() * (m_applet->boundingRect().height() / m_size.height()));
+    } else if (m_applet->formFactor() == Plasma::Vertical) {
+        size.setHeight(m_size.height() * (m_applet->boundingRect().width() / m_size.width()));
+    }
+
+    setMinimumSize(size);
+}
+
+void ThemeWidget::updateFrame()
+{
+    if (m_framePending && m_frameDirty) {
+        finishFrameTime();
+    }
+
+    m_frameTime.start();
+
+    m_framePending = false;
+    m_frameDirty = false;
+
+    updateComponent(MillisecondComponent);
+
+    if (m_rootObject) {
+        finishFrameTime();
+    } else {
+        m_framePending = true;
+    }
+}
+
+void ThemeWidget::finishFrameTime()
+{
+    const int time = m_frameTime.elapsed();
+
+    if (time > m_frameTimer.interval()) {
+        ++m_frameOverruns;
+
+        emit frameBudgetExceeded(time);
+    }
+}
+
+void ThemeWidget::prepareFrame()
+{
+    if (m_speculativeDateTime.isValid() || m_frameRate > 0 || m_native || m_loading || m_rootObject || !m_page || m_page->isContentEditable() || !isVisible() || boundingRect().isEmpty()) {
+        return;
+    }
+
+    const QDateTime dateTime = m_clock->getDateTime();
+
+    if (!dateTime.isValid() || m_clock->getValue(MillisecondComponent, ComponentOptions(ShortOption)).toInt() > 900) {
+        return;
+    }
+
+    const QList<ClockComponent> components = m_clock->getPredictedComponents();
+
+    if (components.isEmpty() || !isPredictable(components)) {
+        return;
+    }
+
+    m_speculativeDateTime = dateTime.addSecs(1);
+    m_speculativeComponents = components;
+
+    m_speculationPage = new QWebPage(this);
+    m_speculationPage->setNetworkAccessManager(m_manager);
+    m_speculationPage->setPalette(m_page->palette());
+    m_speculationPage->setViewportSize(m_page->viewportSize());
+    m_speculationPage->settings()->setFontFamily(QWebSettings::StandardFont, "sans");
+    m_speculationPage->settings()->setAttribute(QWebSettings::JavascriptEnabled, false);
+
+    connect(m_speculationPage, SIGNAL(loadFinished(bool)), this, SLOT(renderFrame(bool)));
+
+    m_speculationPage->mainFrame()->setHtml(m_page->mainFrame()->toHtml(), QUrl("clock://theme/"));
+    m_speculationPage->mainFrame()->setZoomFactor(m_page->mainFrame()->zoomFactor());
+}
+
+void ThemeWidget::renderFrame(bool ok)
+{
+    if (!m_speculationPage || sender() != m_speculationPage) {
+        return;
+    }
+
+    if (!ok || !m_speculativeDateTime.isValid() || m_clock->getDateTime().addSecs(1) != m_speculativeDateTime) {
+        discardFrame();
+
+        return;
+    }
+
+    QWebElement style = m_speculationPage->mainFrame()->findFirstElement("#theme_css");
+
+    if (!style.isNull()) {
+        style.setPlainText(m_styleSheet);
+    }
+
+    m_clock->setPrediction(true);
+
+    for (int i = 0; i < m_speculativeComponents.count(); ++i) {
+        applyElements(m_speculationPage->mainFrame(), m_speculativeComponents.at(i));
+    }
+
+    m_clock->setPrediction(false);
+
+    QPixmap pixmap(boundingRect().size().toSize());
+    pixmap.fill(Qt::transparent);
+
+    QPainter painter(&pixmap);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
+    painter.translate(m_offset);
+
+    m_speculationPage->mainFrame()->render(&painter, QWebFrame::ContentsLayer);
+
+    painter.end();
+
+    m_nextFrame = pixmap;
+
+    m_speculationPage->deleteLater();
+    m_speculationPage = NULL;
+}
+
+void ThemeWidget::finishFrame()
+{
+    if (!m_speculativeDateTime.isValid()) {
+        return;
+    }
+
+    m_speculativeDateTime = QDateTime();
+    m_speculativeComponents.clear();
+    m_nextFrame = QPixmap();
+
+    if (m_speculationPage) {
+        m_speculationPage->deleteLater();
+        m_speculationPage = NULL;
+    }
+
+    m_speculationTimer.start(100);
+}
 
-    connect(m_page.mainFrame(), SIGNAL(contentsSizeChanged(QSize)), this, SLOT(updateSize()));
+void ThemeWidget::discardFrame()
+{
+    const bool presented = !m_frame.isNull();
+
+    m_speculativeDateTime = QDateTime();
+    m_speculativeComponents.clear();
+    m_frame = QPixmap();
+    m_nextFrame = QPixmap();
+
+    if (m_speculationPage) {
+        m_speculationPage->deleteLater();
+        m_speculationPage = NULL;
+    }
+
+    if (presented) {
+        update();
+    }
+}
+
+bool ThemeWidget::isPredictable(const QList<ClockComponent> &components)
+{
+    QStringList events;
+
+    for (int i = 0; i < components.count(); ++i) {
+        const QWebElementCollection elements = m_page->mainFrame()->findAllElements(QString("[component=%1][attribute]").arg(Clock::getComponentString(components.at(i))));
+
+        for (int j = 0; j < elements.count(); ++j) {
+            const QString transition = elements.at(j).styleProperty("-webkit-transition-duration", QWebElement::ComputedStyle);
+            const QString animation = elements.at(j).styleProperty("-webkit-animation-name", QWebElement::ComputedStyle);
+
+            if ((!transition.isEmpty() && transition != "0s") || (!animation.isEmpty() && animation != "none")) {
+                return false;
+            }
+        }
+
+        events.append(QString("'Clock%1Changed'").arg(Clock::getComponentString(components.at(i))));
+    }
+
+    return m_page->mainFrame()->evaluateJavaScript(QString("(typeof ClockTracker != 'undefined' && ClockTracker.isIdle([%1]))").arg(events.join(","))).toBool();
+}
+
+void ThemeWidget::installTracker()
+{
+    static QString tracker;
+
+    if (tracker.isEmpty()) {
+        QFile file(":/tracker.js");
+        file.open(QIODevice::ReadOnly | QIODevice::Text);
+
+        QTextStream stream(&file);
+        stream.setCodec("UTF-8");
+
+        tracker = stream.readAll();
+    }
+
+    m_page->mainFrame()->evaluateJavaScript(tracker);
 }
 
 void ThemeWidget::setHtml(const QString &path, const QString &html, const QString &css)
 {
+    if (css.isEmpty()) {
+        const QString description = NativeTheme::fromHtml(html);
+
+        if (!description.isEmpty() && setDescription(path, description)) {
+            m_html = html;
+
+            return;
+        }
+    }
+
     clear();
 
     m_css = css;
@@ -217,40 +674,107 @@ void ThemeWidget::setHtml(const QString &path, const QString &html, const QStrin
     setAcceptedMouseButtons(Qt::LeftButton);
     setFlag(QGraphicsItem::ItemHasNoContents, false);
 
-    m_page.mainFrame()->setHtml(html);
-    m_page.mainFrame()->addToJavaScriptWindowObject("Clock", m_clock, QScriptEngine::QtOwnership);
+    getPage()->mainFrame()->setHtml(html, QUrl("clock://theme/"));
+    getPage()->mainFrame()->addToJavaScriptWindowObject("Clock", m_clock, QScriptEngine::QtOwnership);
 
-    for (int i = 1; i < LastComponent; ++i) {
-        m_page.mainFrame()->evaluateJavaScript(QString("Clock.%1 = %2;").arg(Clock::getComponentString(static_cast<ClockComponent>(i))).arg(i));
-    }
+    static QString bootstrap;
 
-    QFile file(":/helper.js");
-    file.open(QIODevice::ReadOnly | QIODevice::Text);
+    if (bootstrap.isEmpty()) {
+        QFile file(":/bootstrap.js");
+        file.open(QIODevice::ReadOnly | QIODevice::Text);
+
+        QTextStream stream(&file);
+        stream.setCodec("UTF-8");
 
-    QTextStream stream(&file);
-    stream.setCodec("UTF-8");
+        bootstrap = stream.readAll();
+    }
 
-    m_page.mainFrame()->evaluateJavaScript(stream.readAll());
+    getPage()->mainFrame()->evaluateJavaScript(bootstrap);
 
     updateTheme();
-
-    m_page.mainFrame()->evaluateJavaScript("Clock.sendEvent('ClockOptionsChanged')");
+    setFrameRate(getPage()->mainFrame()->findFirstElement("body").attribute("framerate").toInt());
+    applyComponents();
 
     if (m_css.isEmpty()) {
         QTimer::singleShot(500, this, SLOT(updateSize()));
     }
 
-    connect(Plasma::Theme::defaultTheme(), SIGNAL(themeChanged()), this, SLOT(updateTheme()));
+    replaceSnapshot();
+
+    connect(Plasma::Theme::defaultTheme(), SIGNAL(themeChanged()), &m_themeTimer, SLOT(start()));
+}
+
+bool ThemeWidget::setDescription(const QString &path, const QString &description)
+{
+    clear();
+
+    m_native = new NativeTheme(m_clock, this);
+
+    if (!m_native->setDescription(description)) {
+        delete m_native;
+
+        m_native = NULL;
+
+        return false;
+    }
+
+    if (m_page) {
+        m_page->deleteLater();
+
+        m_page = NULL;
+        m_manager = NULL;
+    }
+
+    m_clock->setTheme(path, NativeType);
+
+    setFlag(QGraphicsItem::ItemHasNoContents, false);
+
+    updateTheme();
+    replaceSnapshot();
+
+    connect(Plasma::Theme::defaultTheme(), SIGNAL(themeChanged()), &m_themeTimer, SLOT(start()));
+
+    return true;
 }
 
 QWebPage* ThemeWidget::getPage()
 {
-    return &m_page;
+    if (!m_page) {
+        QWebSecurityOrigin::addLocalScheme(QLatin1String("clock"));
+
+        ThemePage *page = new ThemePage(this);
+
+        m_page = page;
+        m_manager = new NetworkAccessManager(m_clock, m_page);
+
+        m_page->setNetworkAccessManager(m_manager);
+
+        QPalette palette = m_page->palette();
+        palette.setBrush(QPalette::Base, Qt::transparent);
+
+        m_page->setPalette(palette);
+        m_page->settings()->setFontFamily(QWebSettings::StandardFont, "sans");
+
+        connect(m_page, SIGNAL(repaintRequested(QRect)), this, SLOT(update()));
+        connect(m_page->mainFrame(), SIGNAL(javaScriptWindowObjectCleared()), this, SLOT(installTracker()));
+        connect(page, SIGNAL(scriptInterrupted()), this, SLOT(disableScripts()));
+    }
+
+    return m_page;
+}
+
+QVariant ThemeWidget::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    if (change == QGraphicsItem::ItemVisibleHasChanged) {
+        setFrameRate(m_frameRate);
+    }
+
+    return Plasma::DeclarativeWidget::itemChange(change, value);
 }
 
 QString ThemeWidget::getValue(const QString &component, const QString &options) const
 {
-    return m_clock->evaluate(QString("Clock.getValue(Clock.%1, {%2})").arg(component).arg(QString(options).replace('\'', '"')));
+    return m_clock->getValue(Clock::getComponent(component), ComponentOptions::fromString(options)).toString();
 }
 
 bool ThemeWidget::setTheme(const QString &path)
@@ -260,27 +784,32 @@ bool ThemeWidget::setTheme(const QString &path)
     const QString qmlPath = (path + "/contents/ui/main.qml");
 
     if (QFile::exists(qmlPath)) {
-        setQmlPath(qmlPath);
+        if (!m_context) {
+            m_context = new ClockContext(m_clock, this);
 
-        m_rootObject = rootObject();
+            engine()->rootContext()->setContextProperty("clock", m_context);
+            engine()->rootContext()->setContextProperty("Clock", m_clock);
+            engine()->addImageProvider("adjustableclock", new ImageProvider());
+        }
 
         m_clock->setTheme(path, QmlType);
+        m_context->updateOptions();
 
-        const QList<QObject*> objects = m_rootObject->findChildren<QObject*>();
+        m_size = QSize(150, 100);
+        m_loading = true;
 
-        for (int i = 0; i < objects.count(); ++i) {
-            const QVariantMap options = objects.at(i)->property("adjustableClock").toMap();
+        setFlag(QGraphicsItem::ItemHasNoContents, false);
+        setQmlPath(qmlPath);
+    } else if (QFile::exists(path + "/contents/ui/main.xml")) {
+        QFile file(path + "/contents/ui/main.xml");
+        file.open(QIODevice::ReadOnly | QIODevice::Text);
 
-            if (!options.isEmpty()) {
-                const ClockComponent component = static_cast<ClockComponent>(m_clock->evaluate(QString("Clock.%1").arg(options.value("component").toString())).toInt());
-                QList<QPointer <QObject> > list = m_objects.value(component);
-                list.append(objects.at(i));
+        QTextStream stream(&file);
+        stream.setCodec("UTF-8");
 
-                m_objects[component] = list;
-            }
+        if (!setDescription(path, stream.readAll())) {
+            return false;
         }
-
-        m_size = QSize(m_rootObject->property("minimumWidth").toInt(), m_rootObject->property("minimumHeight").toInt()).expandedTo(QSize(150, 100));
     } else {
         QFile file(path + "/contents/ui/main.html");
         file.open(QIODevice::ReadOnly | QIODevice::Text);
@@ -297,22 +826,176 @@ bool ThemeWidget::setTheme(const QString &path)
         setHtml(path, html);
     }
 
-    for (int i = 1; i < LastComponent; ++i) {
-        updateComponent(static_cast<ClockComponent>(i));
+    if (m_native || m_loading) {
+        for (int i = 1; i < LastComponent; ++i) {
+            updateComponent(static_cast<ClockComponent>(i));
+        }
+    }
+
+    updateSize();
+    updateBackground();
+
+    return true;
+}
+
+void ThemeWidget::updateOptions()
+{
+    if (m_rootObject || m_loading) {
+        m_context->updateOptions();
+
+        return;
+    }
+
+    discardFrame();
+
+    if (m_native) {
+        m_native->updateOptions();
+
+        updateSize();
+        update();
+
+        return;
+    }
+
+    getPage()->mainFrame()->evaluateJavaScript("Clock.sendEvent('ClockOptionsChanged');Clock.sendEvent('ClockThemeChanged');");
+}
+
+void ThemeWidget::finishLoading()
+{
+    if (!m_loading || !rootObject()) {
+        return;
     }
 
+    m_rootObject = rootObject();
+    m_loading = false;
+    m_size = QSize(m_rootObject->property("minimumWidth").toInt(), m_rootObject->property("minimumHeight").toInt()).expandedTo(QSize(150, 100));
+
+    setFlag(QGraphicsItem::ItemHasNoContents, true);
+    setFrameRate(m_rootObject->property("frameRate").toInt());
     updateSize();
+    updateBackground();
+    discardSnapshot();
+    update();
+}
 
+void ThemeWidget::updateBackground()
+{
     if (m_applet) {
         m_applet->setBackgroundHints((m_applet->formFactor() != Plasma::Horizontal && m_applet->formFactor() != Plasma::Vertical && getBackgroundFlag()) ? Plasma::Applet::DefaultBackground : Plasma::Applet::NoBackground);
     }
+}
 
-    return true;
+void ThemeWidget::setFrameRate(int rate)
+{
+    m_frameRate = (m_throttled ? 0 : qBound(0, rate, 60));
+    m_framePending = false;
+
+    if (m_frameRate > 0 && isVisible()) {
+        m_frameTimer.start(1000 / m_frameRate);
+    } else {
+        m_frameTimer.stop();
+    }
 }
 
 bool ThemeWidget::getBackgroundFlag() const
 {
-    return (m_rootObject ? m_rootObject->property("background").toBool() : (m_page.mainFrame()->findFirstElement("body").attribute("background").toLower() == "true"));
+    if (m_native) {
+        return m_native->getBackgroundFlag();
+    }
+
+    return (m_rootObject ? m_rootObject->property("background").toBool() : (m_page && m_page->mainFrame()->findFirstElement("body").attribute("background").toLower() == "true"));
+}
+
+void ThemeWidget::discardSnapshot()
+{
+    if (m_snapshot.isNull()) {
+        return;
+    }
+
+    m_snapshot = QPixmap();
+    m_snapshotPending = false;
+    m_snapshotReplaced = false;
+
+    setFlag(QGraphicsItem::ItemHasNoContents, (m_rootObject != NULL));
+    update();
+}
+
+void ThemeWidget::replaceSnapshot()
+{
+    if (m_snapshot.isNull()) {
+        return;
+    }
+
+    m_snapshotPending = false;
+    m_snapshotReplaced = true;
+
+    update();
+}
+
+void ThemeWidget::setSnapshot(const QImage &snapshot)
+{
+    const QStringList size = snapshot.text("Size").split(QLatin1Char('x'));
+
+    m_snapshot = QPixmap::fromImage(snapshot);
+    m_snapshotPending = (!m_snapshot.isNull() && snapshot.text("Type") != QLatin1String("native"));
+    m_snapshotReplaced = false;
+
+    if (!m_snapshot.isNull() && size.count() == 2 && size.at(0).toInt() > 0 && size.at(1).toInt() > 0) {
+        m_size = QSize(size.at(0).toInt(), size.at(1).toInt());
+
+        updateMinimumSize();
+    }
+
+    setFlag(QGraphicsItem::ItemHasNoContents, m_snapshot.isNull());
+    update();
+}
+
+QImage ThemeWidget::getSnapshot()
+{
+    if ((!m_snapshot.isNull() && !m_snapshotReplaced) || m_rootObject || m_loading || boundingRect().isEmpty()) {
+        return QImage();
+    }
+
+    QImage snapshot(boundingRect().size().toSize(), QImage::Format_ARGB32_Premultiplied);
+    snapshot.fill(0);
+
+    QPainter painter(&snapshot);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
+
+    if (m_native) {
+        m_native->paint(&painter, boundingRect());
+    } else {
+        painter.translate(m_offset);
+
+        getPage()->mainFrame()->render(&painter, QWebFrame::ContentsLayer);
+    }
+
+    painter.end();
+
+    snapshot.setText("Type", (m_native ? "native" : "html"));
+    snapshot.setText("Size", QString("%1x%2").arg(m_size.width()).arg(m_size.height()));
+
+    return snapshot;
+}
+
+bool ThemeWidget::isSnapshotPending() const
+{
+    return (m_snapshotPending && isVisible());
+}
+
+void ThemeWidget::setTickBudget(int budget)
+{
+    m_tickBudget = qMax(1, budget);
+}
+
+int ThemeWidget::getFrameOverruns() const
+{
+    return m_frameOverruns;
+}
+
+int ThemeWidget::getScriptOverruns() const
+{
+    return m_scriptOverruns;
 }
 
 }
@@ -23,14 +23,23 @@
 
 #include "Clock.h"
 
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtGui/QImage>
+#include <QtGui/QPixmap>
 #include <QtWebKit/QWebPage>
+#include <QtWebKit/QWebFrame>
 
 #include <Plasma/DeclarativeWidget>
 
 namespace AdjustableClock
 {
 
-class ThemeWidget : public Plasma::DeclarativeWidget
+class NativeTheme;
+class ClockContext;
+class NetworkAccessManager;
+
+class ADJUSTABLECLOCK_EXPORT ThemeWidget : public Plasma::DeclarativeWidget
 {
     Q_OBJECT
 
@@ -38,33 +47,92 @@ class ThemeWidget : public Plasma::DeclarativeWidget
         explicit ThemeWidget(Clock *clock, Applet *parent = NULL);
 
         void setHtml(const QString &path, const QString &html, const QString &css = QString());
+        bool setDescription(const QString &path, const QString &description);
         QWebPage* getPage();
         bool setTheme(const QString &path);
+        void updateOptions();
         bool getBackgroundFlag() const;
+        void setTickBudget(int budget);
+        void setSnapshot(const QImage &snapshot);
+        QImage getSnapshot();
+        bool isSnapshotPending() const;
+        int getFrameOverruns() const;
+        int getScriptOverruns() const;
+
+    public slots:
+        void setFrameRate(int rate);
 
     protected:
         void resizeEvent(QGraphicsSceneResizeEvent *event);
         void mousePressEvent(QGraphicsSceneMouseEvent *event);
         void hoverMoveEvent(QGraphicsSceneHoverEvent *event);
         void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = NULL);
+        void paintTheme(QPainter *painter);
+        void finishFrameTime();
         void clear();
         QString getValue(const QString &component, const QString &options) const;
+        QVariant itemChange(GraphicsItemChange change, const QVariant &value);
+        bool isPredictable(const QList<ClockComponent> &components);
+        void updateMinimumSize();
+        void applyComponent(ClockComponent component);
+        void applyElements(QWebFrame *frame, ClockComponent component);
+        void applyComponents();
 
     protected slots:
         void update();
         void updateComponent(ClockComponent component);
         void updateTheme();
         void updateSize();
+        void updateBackground();
+        void finishLoading();
+        void updateFrame();
+        void prepareFrame();
+        void renderFrame(bool ok);
+        void finishFrame();
+        void discardFrame();
+        void disableScripts();
+        void installTracker();
+        void discardSnapshot();
+        void replaceSnapshot();
 
     private:
         Applet *m_applet;
         Clock *m_clock;
         QObject *m_rootObject;
-        QWebPage m_page;
-        QMap<ClockComponent, QList<QPointer<QObject> > > m_objects;
+        QWebPage *m_page;
+        NetworkAccessManager *m_manager;
+        NativeTheme *m_native;
+        ClockContext *m_context;
+        QWebPage *m_speculationPage;
+        QTimer m_frameTimer;
+        QTimer m_speculationTimer;
+        QTimer m_themeTimer;
+        QElapsedTimer m_frameTime;
+        QPixmap m_frame;
+        QPixmap m_nextFrame;
+        QPixmap m_snapshot;
+        QDateTime m_speculativeDateTime;
+        QList<ClockComponent> m_speculativeComponents;
         QSize m_size;
         QPointF m_offset;
+        QString m_html;
         QString m_css;
+        QString m_styleSheet;
+        int m_frameRate;
+        int m_frameOverruns;
+        int m_scriptOverruns;
+        int m_tickBudget;
+        bool m_loading;
+        bool m_throttled;
+        bool m_framePending;
+        bool m_frameDirty;
+        bool m_snapshotPending;
+        bool m_snapshotReplaced;
+
+    signals:
+        void frameBudgetExceeded(int time);
+        void scriptBudgetExceeded(int time);
+        void snapshotPresented();
 };
 
 }
@@ -0,0 +1,16 @@
+file(STRINGS ${HEADER} _lines REGEX "^    [A-Za-z]+Component = [0-9]+,?$")
+
+set(_bootstrap "")
+
+foreach(_line ${_lines})
+	string(REGEX REPLACE "^    ([A-Za-z]+)Component = ([0-9]+),?$" "\\1;\\2" _component ${_line})
+	list(GET _component 0 _name)
+	list(GET _component 1 _value)
+
+	if(NOT _name STREQUAL "Invalid" AND NOT _name STREQUAL "Last")
+		set(_bootstrap "${_bootstrap}Clock.${_name} = ${_value};\n")
+	endif(NOT _name STREQUAL "Invalid" AND NOT _name STREQUAL "Last")
+endforeach(_line)
+
+file(READ ${HELPER} _helper)
+file(WRITE ${OUTPUT} "${_bootstrap}\n${_helper}")
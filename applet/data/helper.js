@@ -8,19 +8,77 @@ Clock.sendEvent = function (name)
 
 Clock.setStyleSheet = function (data)
 {
-	var link = document.getElementById('theme_css');
+	var style = document.getElementById('theme_css');
 
-	if (!link)
+	if (!style)
 	{
-		link = document.createElement('link');
-		link.setAttribute('id', 'theme_css');
-		link.setAttribute('rel', 'stylesheet');
-		link.setAttribute('type', 'text/css');
+		style = document.createElement('style');
+		style.setAttribute('id', 'theme_css');
+		style.setAttribute('type', 'text/css');
+		style.appendChild(document.createTextNode(data));
 
-		document.head.insertBefore(link, document.head.firstChild);
+		document.head.insertBefore(style, document.head.firstChild);
+
+		return;
+	}
+
+	var scratch = document.createElement('style');
+	scratch.setAttribute('type', 'text/css');
+	scratch.setAttribute('media', 'not all');
+	scratch.appendChild(document.createTextNode(data));
+
+	document.head.appendChild(scratch);
+
+	var current = style.sheet;
+	var next = scratch.sheet;
+
+	for (var i = 0; i < next.cssRules.length; ++i)
+	{
+		var rule = next.cssRules[i];
+		var currentRule = ((i < current.cssRules.length) ? current.cssRules[i] : null);
+
+		if (currentRule && currentRule.cssText == rule.cssText)
+		{
+			continue;
+		}
+
+		if (currentRule && currentRule.type == CSSRule.STYLE_RULE && rule.type == CSSRule.STYLE_RULE && currentRule.selectorText == rule.selectorText)
+		{
+			for (var j = (currentRule.style.length - 1); j >= 0; --j)
+			{
+				if (rule.style.getPropertyValue(currentRule.style[j]) === '' || rule.style.getPropertyValue(currentRule.style[j]) === null)
+				{
+					currentRule.style.removeProperty(currentRule.style[j]);
+				}
+			}
+
+			for (var j = 0; j < rule.style.length; ++j)
+			{
+				var property = rule.style[j];
+
+				if (currentRule.style.getPropertyValue(property) != rule.style.getPropertyValue(property) || currentRule.style.getPropertyPriority(property) != rule.style.getPropertyPriority(property))
+				{
+					currentRule.style.setProperty(property, rule.style.getPropertyValue(property), rule.style.getPropertyPriority(property));
+				}
+			}
+
+			continue;
+		}
+
+		if (currentRule)
+		{
+			current.deleteRule(i);
+		}
+
+		current.insertRule(rule.cssText, i);
+	}
+
+	while (current.cssRules.length > next.cssRules.length)
+	{
+		current.deleteRule(current.cssRules.length - 1);
 	}
 
-	link.setAttribute('href', ('data:text/css;charset=utf-8;base64,' + window.btoa('html, body {margin: 0; padding: 0;} ' + data)));
+	document.head.removeChild(scratch);
 }
 
 Clock.setStyle = function (object, property, value)
@@ -8,4 +8,10 @@ Item
 	property bool background: true
 	property int minimumWidth: 100
 	property int minimumHeight: 150
+
+	Text
+	{
+		anchors.centerIn: parent
+		text: clock.hour + ':' + clock.minute
+	}
 }
\ No newline at end of file
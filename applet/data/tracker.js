@@ -0,0 +1,105 @@
+var ClockTracker = {listeners: [], timers: {}};
+
+ClockTracker.isIdle = function (events)
+{
+	for (var id in ClockTracker.timers)
+	{
+		return false;
+	}
+
+	for (var i = 0; i < ClockTracker.listeners.length; ++i)
+	{
+		if (events.indexOf(ClockTracker.listeners[i].type) >= 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+ClockTracker.findListener = function (type, listener, capture)
+{
+	for (var i = 0; i < ClockTracker.listeners.length; ++i)
+	{
+		if (ClockTracker.listeners[i].type == type && ClockTracker.listeners[i].listener == listener && ClockTracker.listeners[i].capture == !!capture)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+ClockTracker.addEventListener = document.addEventListener;
+ClockTracker.removeEventListener = document.removeEventListener;
+ClockTracker.setTimeout = window.setTimeout;
+ClockTracker.clearTimeout = window.clearTimeout;
+ClockTracker.setInterval = window.setInterval;
+ClockTracker.clearInterval = window.clearInterval;
+
+document.addEventListener = function (type, listener, capture)
+{
+	if (ClockTracker.findListener(type, listener, capture) < 0)
+	{
+		ClockTracker.listeners.push({type: type, listener: listener, capture: !!capture});
+	}
+
+	ClockTracker.addEventListener.call(document, type, listener, capture);
+}
+
+document.removeEventListener = function (type, listener, capture)
+{
+	var index = ClockTracker.findListener(type, listener, capture);
+
+	if (index >= 0)
+	{
+		ClockTracker.listeners.splice(index, 1);
+	}
+
+	ClockTracker.removeEventListener.call(document, type, listener, capture);
+}
+
+window.setTimeout = function (callback, delay)
+{
+	var id = ClockTracker.setTimeout.call(window, function ()
+	{
+		delete ClockTracker.timers[id];
+
+		if (typeof callback == 'function')
+		{
+			callback();
+		}
+		else
+		{
+			window.eval(callback);
+		}
+	}, delay);
+
+	ClockTracker.timers[id] = true;
+
+	return id;
+}
+
+window.clearTimeout = function (id)
+{
+	delete ClockTracker.timers[id];
+
+	ClockTracker.clearTimeout.call(window, id);
+}
+
+window.setInterval = function (callback, delay)
+{
+	var id = ClockTracker.setInterval.call(window, callback, delay);
+
+	ClockTracker.timers[id] = true;
+
+	return id;
+}
+
+window.clearInterval = function (id)
+{
+	delete ClockTracker.timers[id];
+
+	ClockTracker.clearInterval.call(window, id);
+}